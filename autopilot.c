@@ -0,0 +1,326 @@
+/**
+ * @file autopilot.c
+ * @brief Autopilot: shortest path to the food, kept safe by a fixed
+ * Hamiltonian cycle.
+ * @note The cycle visits every cell once: row 0 left to right, rows 1 to
+ * GRID_HEIGHT - 1 in a serpentine over columns 1 and up, then back up
+ * column 0; an even height makes the serpentine end next to column 0.
+ * Following it can never trap the snake. The body always lies on the
+ * stretch of the cycle from the tail to the head, so a move may skip ahead
+ * along the cycle as long as it lands before the tail. Among those moves
+ * the one closest to the food wins, measured by a breadth-first search
+ * over free cells. The search keeps one bit per cell in row bitmaps and
+ * grows a whole layer with shifts, so it needs 2 * GRID_HEIGHT rows of
+ * stack (56 bytes on the 16x14 grid, 224 on 32x28) and no queue.
+ * On a level with walls the cycle runs through them and guarantees
+ * nothing. A free move is taken only if a flood fill from it finds room
+ * to last until the body next to that room moves on; the search picks the
+ * shortest path to the food among those, through the same two row
+ * buffers.
+ */
+
+#include "config.h"
+#include "geometry.h"
+#include "grid.h"
+#include "level.h"
+#include "snake.h"
+#include "types.h"
+
+#define ROW_BYTES (GRID_WIDTH / 8)
+#define AUTOPILOT_SLACK 4  // Cells kept between a shortcut and the tail
+
+#if GRID_WIDTH <= 16
+typedef uint16_t Row;
+#else
+typedef uint32_t Row;
+#endif
+
+#define ROW_MASK ((Row)(~(Row)0 >> (sizeof(Row) * 8 - GRID_WIDTH)))
+
+/**
+ * @brief Position of a cell along the Hamiltonian cycle.
+ * @param p Cell.
+ * @return Index in 0..GRID_CELLS - 1.
+ */
+static uint16_t cycle_index(Point p) {
+  if (p.y == 0)
+    return p.x;
+  if (p.x == 0)
+    return GRID_CELLS - p.y;
+  uint16_t row = GRID_WIDTH + (p.y - 1) * (GRID_WIDTH - 1);
+  return row + ((p.y & 1) ? GRID_WIDTH - 1 - p.x : p.x - 1);
+}
+
+/**
+ * @brief Direction from a cell to its successor on the cycle.
+ * @param p Cell.
+ * @return One of the DIRECTION_* values.
+ */
+static uint8_t cycle_direction(Point p) {
+  if (p.y == 0)
+    return p.x < GRID_WIDTH - 1 ? DIRECTION_RIGHT : DIRECTION_DOWN;
+  if (p.x == 0)
+    return DIRECTION_UP;
+  if (p.y & 1) {
+    if (p.x > 1 || p.y == GRID_HEIGHT - 1)
+      return DIRECTION_LEFT;
+    return DIRECTION_DOWN;
+  }
+  return p.x < GRID_WIDTH - 1 ? DIRECTION_RIGHT : DIRECTION_DOWN;
+}
+
+/**
+ * @brief Cycle distance from the head's cell to another cell.
+ */
+static uint16_t ahead_of(uint16_t head, Point p) {
+  uint16_t index = cycle_index(p);
+  return index >= head ? index - head : index + GRID_CELLS - head;
+}
+
+/**
+ * @brief Loads the free cells of the grid as row bitmaps.
+ * @param state Pointer to the current GameState structure.
+ * @param open Rows to fill, one bit per free cell.
+ */
+static void load_open(const GameState* state, Row* open) {
+  for (uint8_t y = 0; y < GRID_HEIGHT; y++) {
+    Row row = 0;
+    for (uint8_t b = 0; b < ROW_BYTES; b++) {
+      row |= (Row)state->occupancy.cells[y * ROW_BYTES + b] << (8 * b);
+    }
+    open[y] = ~row & ROW_MASK;
+  }
+}
+
+/**
+ * @brief Grows a search layer by one cell in every direction, wrapping at
+ * the edges, into the open cells, which are then closed.
+ * @param layer Current layer, replaced by the next one.
+ * @param open Cells not yet reached.
+ * @return Non-zero if the layer grew.
+ */
+static Row grow(Row* layer, Row* open) {
+  Row grown = 0;
+  Row above = layer[GRID_HEIGHT - 1];
+  Row first = layer[0];
+  for (uint8_t y = 0; y < GRID_HEIGHT; y++) {
+    Row row = layer[y];
+    Row below = y < GRID_HEIGHT - 1 ? layer[y + 1] : first;
+    Row next = ((row << 1) | (row >> (GRID_WIDTH - 1)) | (row >> 1) |
+                (row << (GRID_WIDTH - 1)) | above | below) &
+               open[y];
+    open[y] &= ~next;
+    layer[y] = next;
+    grown |= next;
+    above = row;
+  }
+  return grown;
+}
+
+/**
+ * @brief Measures the way out the head keeps after a move.
+ * @param state Pointer to the current GameState structure.
+ * @param snake Pointer to the Snake being steered.
+ * @param from Cell the head moves to.
+ * @param blocked Cell taken as well, the body's next cell on the way.
+ * @param open Scratch rows, GRID_HEIGHT of them.
+ * @param layer Scratch rows, GRID_HEIGHT of them.
+ * @return Free cells around the cell, at most the snake's length, or 0 if
+ * they run out before a body segment next to them moves away.
+ * @note Segment k from the tail is gone after k + 1 moves, so the head
+ * escapes if the region holds more than k cells, one more if the food is
+ * in it; once the region reaches the snake's length the head itself is
+ * such a segment.
+ */
+static uint16_t has_way_out(const GameState* state, const Snake* snake,
+                            Point from, Point blocked, Row* open,
+                            Row* layer) {
+  load_open(state, open);
+  open[blocked.y] &= ~((Row)1 << blocked.x);
+  for (uint8_t y = 0; y < GRID_HEIGHT; y++) {
+    layer[y] = 0;
+  }
+  layer[from.y] = (Row)1 << from.x;
+  open[from.y] &= ~layer[from.y];
+  while (grow(layer, open))
+    ;
+
+  // Cells the flood reached, counted up to the snake's length
+  load_open(state, layer);
+  layer[blocked.y] &= ~((Row)1 << blocked.x);
+  uint16_t room = 0;
+  for (uint8_t y = 0; y < GRID_HEIGHT; y++) {
+    layer[y] &= ~open[y];
+    for (Row row = layer[y]; row && room < snake->length; row &= row - 1) {
+      room++;
+    }
+  }
+
+  // Eating in the region holds the tail back a move
+  uint16_t delay = layer[state->food.y] >> state->food.x & 1;
+
+  SnakeIter it;
+  snake_first(snake, &it);
+  for (uint16_t k = 0; k + delay < room; k++) {
+    for (uint8_t d = 0; d < 4; d++) {
+      Point p = snake_step(it.pos, d);
+      if (layer[p.y] >> p.x & 1)
+        return room;
+    }
+    if (!it.remaining)
+      break;
+    snake_next(snake, &it);
+  }
+  return 0;
+}
+
+/**
+ * @brief Finds the moves closest to a target over free cells.
+ * @param state Pointer to the current GameState structure.
+ * @param target Cell the search starts from, searched even if taken.
+ * @param moves Cells the four moves land on.
+ * @param candidates Bit mask of the moves to consider.
+ * @param open Scratch rows, GRID_HEIGHT of them.
+ * @param layer Scratch rows, GRID_HEIGHT of them.
+ * @return Bit mask of the candidates at the shortest distance, 0 if none
+ * is connected to the target.
+ */
+static uint8_t nearest(const GameState* state, Point target,
+                       const Point* moves, uint8_t candidates, Row* open,
+                       Row* layer) {
+  load_open(state, open);
+  for (uint8_t y = 0; y < GRID_HEIGHT; y++) {
+    layer[y] = 0;
+  }
+  layer[target.y] = (Row)1 << target.x;
+  open[target.y] &= ~layer[target.y];
+
+  uint8_t reached = 0;
+  for (uint16_t step = 0; step < GRID_CELLS && !reached; step++) {
+    for (uint8_t d = 0; d < 4; d++) {
+      if ((candidates & (1 << d)) && (layer[moves[d].y] >> moves[d].x & 1)) {
+        reached |= 1 << d;
+      }
+    }
+    if (!grow(layer, open))
+      break;
+  }
+  return reached;
+}
+
+/**
+ * @brief Picks the direction for the next move.
+ * @param state Pointer to the current GameState structure.
+ * @param snake Pointer to the Snake to steer.
+ * @return One of the DIRECTION_* values.
+ * @note Shortcuts are taken only while the snake covers less than half the
+ * grid and never pass the food; otherwise the snake follows the cycle.
+ * @note With another snake on the grid the cycle guarantee is gone: when
+ * the next cycle cell is taken, any free neighbour is used instead.
+ * @note On a walled level a move toward the food must keep a way out, at
+ * its own cell and at the food after eating. While no such move exists
+ * the snake waits in safe moves until the body opens the way.
+ */
+uint8_t autopilot_direction(const GameState* state, const Snake* snake) {
+  Point head = snake_head(snake);
+  uint16_t headIndex = cycle_index(head);
+  uint16_t toTail = ahead_of(headIndex, snake_tail(snake));
+  uint16_t toFood = ahead_of(headIndex, state->food);
+
+  uint16_t reach = 1;
+  if (snake->length < GRID_CELLS / 2 && toTail > AUTOPILOT_SLACK + 1) {
+    reach = toTail - AUTOPILOT_SLACK;
+  }
+  if (toFood && toFood < reach) {
+    reach = toFood;
+  }
+
+  // Scratch rows for the searches
+  Row open[GRID_HEIGHT];
+  Row layer[GRID_HEIGHT];
+
+  // Moves that land free and ahead of the head, but not past the reach;
+  // any free move once walls break the cycle
+  uint8_t cycleSafe = level_is_open(state->level);
+  Point moves[4];
+  uint16_t skips[4];
+  uint8_t candidates = 0;
+  for (uint8_t d = 0; d < 4; d++) {
+    moves[d] = snake_step(head, d);
+    skips[d] = ahead_of(headIndex, moves[d]);
+    if (!grid_test(&(state->occupancy), moves[d]) &&
+        (!cycleSafe || (skips[d] && skips[d] <= reach))) {
+      candidates |= 1 << d;
+    }
+  }
+  if (!candidates) {
+    uint8_t d = cycle_direction(head);
+    for (uint8_t i = 0; i < 3; i++) {
+      if (!grid_test(&(state->occupancy), moves[d]))
+        break;
+      d = (d + 1) & 0x03;
+    }
+    return d;
+  }
+
+  uint8_t reached = nearest(state, state->food, moves, candidates, open,
+                            layer);
+  if (!cycleSafe) {
+    // Moves with a way out, and those keeping the most room
+    uint8_t safe = 0;
+    uint8_t roomy = 0;
+    uint16_t most = 0;
+    for (uint8_t d = 0; d < 4; d++) {
+      if (!(candidates & (1 << d)))
+        continue;
+      uint16_t room = has_way_out(state, snake, moves[d], moves[d], open,
+                                  layer);
+      if (!room)
+        continue;
+      safe |= 1 << d;
+      if (room > most) {
+        most = room;
+        roomy = 0;
+      }
+      if (room == most) {
+        roomy |= 1 << d;
+      }
+    }
+
+    // Toward the food only if the snake can also leave it after eating;
+    // otherwise wait, every length moves switching between following the
+    // tail and keeping the most room so the body never settles in a loop
+    uint8_t leave = 0;
+    for (uint8_t d = 0; d < 4; d++) {
+      if ((reached & safe & (1 << d)) &&
+          has_way_out(state, snake, state->food, moves[d], open, layer)) {
+        leave |= 1 << d;
+      }
+    }
+    if (leave) {
+      reached = leave;
+    } else if (safe) {
+      candidates = safe;
+      reached = roomy;
+      if ((snake->head / snake->length) & 1) {
+        reached = nearest(state, snake_tail(snake), moves, safe, open, layer);
+      }
+    }
+  }
+
+  // Closest to the target first, then furthest along the cycle; with the
+  // target walled off, simply the furthest along the cycle
+  if (reached) {
+    candidates = reached;
+  }
+
+  uint8_t best = 0;
+  uint16_t bestSkip = 0;
+  for (uint8_t d = 0; d < 4; d++) {
+    if ((candidates & (1 << d)) && skips[d] > bestSkip) {
+      best = d;
+      bestSkip = skips[d];
+    }
+  }
+  return best;
+}
@@ -0,0 +1,14 @@
+/**
+ * @file autopilot.h
+ * @brief Header file for the built-in autopilot of the Snake game.
+ */
+
+#ifndef SNAKE_GAME_AUTOPILOT_H
+#define SNAKE_GAME_AUTOPILOT_H
+
+#include <stdint.h>
+#include "types.h"
+
+uint8_t autopilot_direction(const GameState*, const Snake*);
+
+#endif
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Decode PROFILE telemetry frames streamed by profile.c over USART0.
+
+Reads raw bytes from a file or serial device (configure it first, e.g.
+`stty -F /dev/ttyACM0 115200 raw`) and prints one CSV row per probe per
+frame. Main loop states get a second CSV section with its own header:
+wake-ups, awake and asleep cycles and the awake share in per cent. A third
+section has one row per frame for the whole system: game ticks that
+overran, the display queue high water and the display bytes sent, per
+window, per second and since boot. Probe rows stream as frames arrive;
+the other sections follow, each after a blank line, once the input ends
+or the decoder is interrupted. Frame layout is documented in profile.h.
+
+Usage: decode_profile.py [path]   (default: stdin)
+"""
+
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+RECORD = struct.Struct("<BHIII")
+PROBES = {
+    1: "move_snake",
+    2: "render_game",
+    3: "draw_score",
+    4: "place_food",
+    5: "sh1107_init",
+    6: "draw_snake",
+    7: "draw_food",
+    8: "button_isr",
+}
+STATE_ID = 0x40
+SYSTEM_ID = 0x50
+STATES = {
+    0: "playing",
+    1: "paused",
+    2: "game_over",
+    3: "attract",
+}
+
+
+def frames(stream):
+    """Yield validated frame payloads, resynchronising on bad checksums."""
+    buffer = b""
+    while True:
+        chunk = stream.read(64)
+        if not chunk:
+            return
+        buffer += chunk
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                buffer = buffer[-1:]
+                break
+            buffer = buffer[start:]
+            if len(buffer) < 3 or len(buffer) < buffer[2] + 4:
+                break
+            end = buffer[2] + 4
+            payload = buffer[3:end - 1]
+            if sum(payload) & 0xFF == buffer[end - 1]:
+                yield payload
+                buffer = buffer[end:]
+            else:
+                buffer = buffer[1:]
+
+
+def main():
+    if len(sys.argv) > 1:
+        stream = open(sys.argv[1], "rb", buffering=0)
+    else:
+        stream = sys.stdin.buffer
+    states = []
+    system = []
+    print("frame,window_ms,probe,calls,min_cycles,mean_cycles,max_cycles")
+    try:
+        for index, payload in enumerate(frames(stream)):
+            (window,) = struct.unpack_from("<H", payload)
+            for offset in range(2, len(payload) - RECORD.size + 1,
+                                RECORD.size):
+                probe, calls, low, high, mean = RECORD.unpack_from(payload,
+                                                                   offset)
+                if probe == SYSTEM_ID:
+                    # calls: tick overruns, low: queue high water,
+                    # high: bytes sent in the window, mean: since boot
+                    rate = high * 1000 // window if window else 0
+                    system.append(f"{index},{window},{calls},{low},{high},"
+                                  f"{rate},{mean}")
+                    continue
+                if probe >= STATE_ID:
+                    # calls: wake-ups, then awake, asleep, awake per mille
+                    name = STATES.get(probe - STATE_ID, str(probe))
+                    states.append(f"{index},{window},{name},{calls},{low},"
+                                  f"{high},{mean / 10:.1f}")
+                    continue
+                name = PROBES.get(probe, str(probe))
+                print(f"{index},{window},{name},{calls},{low},{mean},{high}")
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    print()
+    print("frame,window_ms,state,wakeups,awake_cycles,asleep_cycles,"
+          "awake_pct")
+    for row in states:
+        print(row)
+
+    print()
+    print("frame,window_ms,tick_overruns,queue_high_water,spi_bytes,"
+          "spi_bytes_per_s,spi_bytes_total")
+    for row in system:
+        print(row)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,381 @@
+/**
+ * @file simbench.c
+ * @brief Cycle-accurate benchmark of the firmware under simavr.
+ * @note Loads a BENCHMARK build of the firmware, drives the config.h
+ * button pins (build with -Ihost/include) from a script or a food-chasing
+ * driver, and times every probe (see probe.h) in CPU cycles. Prints a CSV
+ * table of min/mean/max cycles per probe and snake length bucket, and
+ * exits non-zero if a probe exceeds its budget.
+ *
+ * Usage: simbench -f firmware.elf [-b budgets] [-i script | -L length]
+ *                 [-n ticks]
+ * - -f  Firmware ELF built with -DBENCHMARK.
+ * - -b  Budget file, one "<probe> <max cycles>" per line.
+ * - -i  Input script, one "<tick> <U|D|L|R>" press per line (default:
+ *       chase the food, which dies long before the board is full).
+ * - -L  Long run: hold RIGHT through reset so the attract-mode autopilot
+ *       plays, and stop at its first game over. Fails unless the snake
+ *       reached this length and every length bucket up to it was timed.
+ * - -n  Number of game ticks to run (default 2000).
+ */
+
+#include <simavr/avr_ioport.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_cycle_timers.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../config.h"
+#include "../probe.h"
+
+#define MCU_NAME "atmega328p"
+#define MCU_FREQUENCY 16000000
+#define GPIOR0_ADDR 0x3E
+#define GPIOR1_ADDR 0x4A
+
+#define LENGTH_BUCKET 16
+#define BUCKET_COUNT 64
+#define REPORT_BYTES 7
+#define PRESS_CYCLES (MCU_FREQUENCY / 200)  // Hold buttons for 5 ms
+#define RESTART_CYCLES (MCU_FREQUENCY / 1000 * 60)  // Outlasts DEBOUNCE_TIME
+
+// Port D pins as wired for the configured DISPLAY_TRANSPORT
+#define PIN_UP UP_BTN_PIN
+#define PIN_DOWN DOWN_BTN_PIN
+#define PIN_LEFT LEFT_BTN_PIN
+#define PIN_RIGHT RIGHT_BTN_PIN
+#define PIN_COUNT 4
+
+static const char* probeNames[PROBE_COUNT] = {
+    NULL,          "move_snake", "render_game", "draw_score", "place_food",
+    "sh1107_init", "draw_snake", "draw_food",   "button_isr"};
+
+typedef struct {
+  uint32_t calls;
+  uint64_t total;
+  uint64_t min;
+  uint64_t max;
+} PhaseStats;
+
+static avr_t* avr;
+static PhaseStats stats[PROBE_COUNT][BUCKET_COUNT];
+static uint64_t budgets[PROBE_COUNT];
+static avr_cycle_count_t started[PROBE_COUNT];
+static const int buttonPins[PIN_COUNT] = {PIN_UP, PIN_DOWN, PIN_LEFT,
+                                          PIN_RIGHT};
+static avr_irq_t* buttons[8];
+
+static uint8_t report[REPORT_BYTES];
+static uint8_t reportFill = 0;
+static uint16_t snakeLength = 0;
+static uint16_t longestSnake = 0;
+static uint32_t tick = 0;
+static uint32_t maxTicks = 2000;
+static uint16_t longRun = 0;  // Length the autopilot must reach, 0 if off
+static int finished = 0;      // Long run saw its game over
+
+static FILE* script = NULL;
+static long nextTick = -1;
+static char nextKey = 0;
+
+/**
+ * @brief Returns the probe index for a name, or 0 if unknown.
+ */
+static int probe_by_name(const char* name) {
+  for (int i = 1; i < PROBE_COUNT; i++) {
+    if (probeNames[i] && !strcmp(probeNames[i], name)) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief GPIOR0 write hook: probe entry and exit timestamps.
+ */
+static void on_probe(avr_t* avr, avr_io_addr_t addr, uint8_t v, void* param) {
+  uint8_t id = v & ~PROBE_EXIT;
+  if (id >= PROBE_COUNT) {
+    return;
+  }
+  if (!(v & PROBE_EXIT)) {
+    started[id] = avr->cycle;
+    return;
+  }
+
+  uint64_t cycles = avr->cycle - started[id];
+  uint16_t bucket = snakeLength / LENGTH_BUCKET;
+  if (bucket >= BUCKET_COUNT) {
+    bucket = BUCKET_COUNT - 1;
+  }
+  PhaseStats* s = &stats[id][bucket];
+  if (!s->calls || cycles < s->min) {
+    s->min = cycles;
+  }
+  if (cycles > s->max) {
+    s->max = cycles;
+  }
+  s->total += cycles;
+  s->calls++;
+}
+
+/**
+ * @brief Cycle timer callback that releases every button.
+ */
+static avr_cycle_count_t release(avr_t* avr, avr_cycle_count_t when,
+                                 void* param) {
+  for (int i = 0; i < PIN_COUNT; i++) {
+    avr_raise_irq(buttons[buttonPins[i]], 1);
+  }
+  return 0;
+}
+
+/**
+ * @brief Pulls a button pin low for a while.
+ * @param pin Button pin.
+ * @param cycles How long to hold it: PRESS_CYCLES for a turn, which the
+ * turn queue takes at once, or RESTART_CYCLES for a press the main loop
+ * state machine must see debounced.
+ */
+static void press(int pin, avr_cycle_count_t cycles) {
+  avr_raise_irq(buttons[pin], 0);
+  avr_cycle_timer_register(avr, cycles, release, NULL);
+}
+
+/**
+ * @brief Maps a script letter to a button pin, or -1.
+ */
+static int pin_for(char c) {
+  switch (c) {
+    case 'U':
+      return PIN_UP;
+    case 'D':
+      return PIN_DOWN;
+    case 'L':
+      return PIN_LEFT;
+    case 'R':
+      return PIN_RIGHT;
+    default:
+      return -1;
+  }
+}
+
+/**
+ * @brief Chooses and presses the input for the next tick.
+ */
+static void drive() {
+  uint8_t headX = report[0], headY = report[1];
+  uint8_t foodX = report[2], foodY = report[3];
+  uint8_t gameOver = report[6];
+
+  if (longRun) {
+    // Held through reset to pick attract mode; not pressed again, since
+    // any press hands the game from the autopilot to the player
+    release(avr, 0, NULL);
+    finished = gameOver;
+    return;
+  }
+
+  if (gameOver) {
+    press(PIN_UP, RESTART_CYCLES);
+    return;
+  }
+
+  if (script) {
+    int pin = -1;
+    while (nextTick >= 0 && (uint32_t)nextTick <= tick) {
+      pin = pin_for(nextKey);
+      if (fscanf(script, "%ld %c", &nextTick, &nextKey) != 2) {
+        nextTick = -1;
+      }
+    }
+    if (pin >= 0) {
+      press(pin, PRESS_CYCLES);
+    }
+    return;
+  }
+
+  if (headX < foodX) {
+    press(PIN_RIGHT, PRESS_CYCLES);
+  } else if (headX > foodX) {
+    press(PIN_LEFT, PRESS_CYCLES);
+  } else if (headY < foodY) {
+    press(PIN_DOWN, PRESS_CYCLES);
+  } else {
+    press(PIN_UP, PRESS_CYCLES);
+  }
+}
+
+/**
+ * @brief GPIOR1 write hook: collects the per-tick state record.
+ */
+static void on_report(avr_t* avr, avr_io_addr_t addr, uint8_t v,
+                      void* param) {
+  report[reportFill++] = v;
+  if (reportFill < REPORT_BYTES) {
+    return;
+  }
+  reportFill = 0;
+  snakeLength = report[4] | (report[5] << 8);
+  if (snakeLength > longestSnake) {
+    longestSnake = snakeLength;
+  }
+  tick++;
+  drive();
+}
+
+/**
+ * @brief Loads "<probe> <cycles>" budget lines.
+ */
+static int load_budgets(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    return -1;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), file)) {
+    char name[64];
+    unsigned long long cycles;
+    if (line[0] == '#' || sscanf(line, "%63s %llu", name, &cycles) != 2) {
+      continue;
+    }
+    int id = probe_by_name(name);
+    if (!id) {
+      fprintf(stderr, "%s: unknown probe '%s'\n", path, name);
+      fclose(file);
+      return -1;
+    }
+    budgets[id] = cycles;
+  }
+  fclose(file);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  const char* firmwarePath = NULL;
+  const char* budgetPath = NULL;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "f:b:i:L:n:")) != -1) {
+    switch (opt) {
+      case 'f':
+        firmwarePath = optarg;
+        break;
+      case 'b':
+        budgetPath = optarg;
+        break;
+      case 'i':
+        script = fopen(optarg, "r");
+        if (!script) {
+          perror(optarg);
+          return 1;
+        }
+        if (fscanf(script, "%ld %c", &nextTick, &nextKey) != 2) {
+          nextTick = -1;
+        }
+        break;
+      case 'L':
+        longRun = strtoul(optarg, NULL, 10);
+        break;
+      case 'n':
+        maxTicks = strtoul(optarg, NULL, 10);
+        break;
+      default:
+        firmwarePath = NULL;
+        break;
+    }
+  }
+  if (!firmwarePath) {
+    fprintf(stderr, "usage: %s -f firmware.elf [-b budgets] "
+                    "[-i script | -L length] [-n ticks]\n", argv[0]);
+    return 2;
+  }
+  if (budgetPath && load_budgets(budgetPath)) {
+    return 2;
+  }
+
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if (elf_read_firmware(firmwarePath, &firmware)) {
+    fprintf(stderr, "%s: cannot load firmware\n", firmwarePath);
+    return 2;
+  }
+  avr = avr_make_mcu_by_name(MCU_NAME);
+  if (!avr) {
+    fprintf(stderr, "simavr has no %s core\n", MCU_NAME);
+    return 2;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &firmware);
+  avr->frequency = MCU_FREQUENCY;
+
+  avr_register_io_write(avr, GPIOR0_ADDR, on_probe, NULL);
+  avr_register_io_write(avr, GPIOR1_ADDR, on_report, NULL);
+  for (int i = 0; i < PIN_COUNT; i++) {
+    int pin = buttonPins[i];
+    buttons[pin] = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('D'), pin);
+    avr_raise_irq(buttons[pin], 1);  // Released (pulled up)
+  }
+  if (longRun) {
+    avr_raise_irq(buttons[PIN_RIGHT], 0);
+  }
+
+  int state = cpu_Running;
+  while (tick < maxTicks && !finished && state != cpu_Done &&
+         state != cpu_Crashed) {
+    state = avr_run(avr);
+  }
+  if (state == cpu_Crashed) {
+    fprintf(stderr, "firmware crashed at tick %u\n", tick);
+    return 1;
+  }
+
+  int failed = 0;
+  printf("probe,min_length,max_length,calls,min_cycles,mean_cycles,"
+         "max_cycles,budget\n");
+  for (int id = 1; id < PROBE_COUNT; id++) {
+    if (!probeNames[id]) {
+      continue;
+    }
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+      PhaseStats* s = &stats[id][bucket];
+      if (!s->calls) {
+        continue;
+      }
+      printf("%s,%d,%d,%u,%llu,%llu,%llu,%llu\n", probeNames[id],
+             bucket * LENGTH_BUCKET, bucket * LENGTH_BUCKET + LENGTH_BUCKET - 1,
+             s->calls, (unsigned long long)s->min,
+             (unsigned long long)(s->total / s->calls),
+             (unsigned long long)s->max, (unsigned long long)budgets[id]);
+      if (budgets[id] && s->max > budgets[id]) {
+        fprintf(stderr, "%s: %llu cycles over budget %llu (length %d+)\n",
+                probeNames[id], (unsigned long long)s->max,
+                (unsigned long long)budgets[id], bucket * LENGTH_BUCKET);
+        failed = 1;
+      }
+    }
+  }
+
+  if (longRun) {
+    fprintf(stderr, "longest snake %u after %u ticks\n", longestSnake, tick);
+    if (longestSnake < longRun) {
+      fprintf(stderr, "long run stopped short of length %u\n", longRun);
+      failed = 1;
+    }
+    for (int bucket = 0; bucket <= (longRun - 1) / LENGTH_BUCKET &&
+                         bucket < BUCKET_COUNT; bucket++) {
+      if (!stats[PROBE_MOVE_SNAKE][bucket].calls) {
+        fprintf(stderr, "no move_snake timings for lengths %d-%d\n",
+                bucket * LENGTH_BUCKET,
+                bucket * LENGTH_BUCKET + LENGTH_BUCKET - 1);
+        failed = 1;
+      }
+    }
+  }
+  return failed;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file canvas.c
+ * @brief Page-tile render buffer: composes display pages in RAM.
+ * @note A full 128x128 frame does not fit the ATmega328P's SRAM, so the
+ * canvas holds a tile of CANVAS_PAGES consecutive pages. Drawing ORs into
+ * the tile and clips to it, which keeps overlapping graphics intact within
+ * a page byte. Callers compose everything that falls into the tile, mark
+ * the columns that changed with canvas_touch(), and canvas_flush() sends
+ * just those columns in one transaction. Runs of touched columns separated
+ * by fewer than WINDOW_COST untouched ones are sent as one run, since
+ * addressing a new window costs that many command bytes.
+ */
+
+#include <avr/pgmspace.h>
+#include <string.h>
+#include "config.h"
+#include "display.h"
+
+#if CANVAS_PAGES < 1 || CANVAS_PAGES > DISPLAY_HEIGHT / PAGE_HEIGHT
+#error "CANVAS_PAGES must be between 1 and the number of display pages"
+#endif
+
+#define WINDOW_COST 3  // Command bytes per sh1107_window()
+#define TOUCH_BYTES (DISPLAY_WIDTH / 8)
+
+static uint8_t tile[CANVAS_PAGES][DISPLAY_WIDTH];   // Composed page bytes
+static uint8_t touched[CANVAS_PAGES][TOUCH_BYTES];  // Columns to send
+static uint8_t firstPage = 0;                       // Page held in tile[0]
+
+/**
+ * @brief Starts composing a blank tile.
+ * @param page First display page the tile covers.
+ */
+void canvas_begin(uint8_t page) {
+  firstPage = page;
+  memset(tile, 0, sizeof(tile));
+  memset(touched, 0, sizeof(touched));
+}
+
+/**
+ * @brief ORs an 8-pixel-high sprite into the tile.
+ * @param x Left column (0-127).
+ * @param y Top pixel row; need not be page aligned.
+ * @param sprite Column bytes in program memory (bit n = row n).
+ * @param width Number of columns.
+ * @note Rows outside the tile are clipped.
+ */
+void canvas_sprite_P(uint8_t x, uint8_t y, const uint8_t* sprite,
+                     uint8_t width) {
+  uint8_t page = y / PAGE_HEIGHT - firstPage;  // Wraps if above the tile
+  uint8_t shift = y % PAGE_HEIGHT;
+  for (uint8_t col = 0; col < width && x + col < DISPLAY_WIDTH; col++) {
+    uint8_t bits = pgm_read_byte(&sprite[col]);
+    if (page < CANVAS_PAGES) {
+      tile[page][x + col] |= bits << shift;
+    }
+    if (shift && (uint8_t)(page + 1) < CANVAS_PAGES) {
+      tile[page + 1][x + col] |= bits >> (PAGE_HEIGHT - shift);
+    }
+  }
+}
+
+/**
+ * @brief ORs a one-pixel horizontal line into the tile.
+ * @param x0 First column.
+ * @param x1 Last column (inclusive).
+ * @param y Pixel row; clipped if outside the tile.
+ */
+void canvas_hline(uint8_t x0, uint8_t x1, uint8_t y) {
+  uint8_t page = y / PAGE_HEIGHT - firstPage;
+  if (page >= CANVAS_PAGES)
+    return;
+  for (uint8_t x = x0; x <= x1 && x < DISPLAY_WIDTH; x++) {
+    tile[page][x] |= 1 << (y % PAGE_HEIGHT);
+  }
+}
+
+/**
+ * @brief Marks columns of the page holding a pixel row for sending.
+ * @param x0 First column.
+ * @param x1 Last column (inclusive).
+ * @param y Any pixel row of the page; ignored if outside the tile.
+ */
+void canvas_touch(uint8_t x0, uint8_t x1, uint8_t y) {
+  uint8_t page = y / PAGE_HEIGHT - firstPage;
+  if (page >= CANVAS_PAGES)
+    return;
+  for (uint8_t x = x0; x <= x1 && x < DISPLAY_WIDTH; x++) {
+    touched[page][x / 8] |= 1 << (x % 8);
+  }
+}
+
+/**
+ * @brief Tests whether a column of a tile page was touched.
+ */
+static uint8_t is_touched(uint8_t page, uint8_t x) {
+  return touched[page][x / 8] & (1 << (x % 8));
+}
+
+/**
+ * @brief Sends the touched columns of every page in one transaction.
+ * @note Sends nothing if no column was touched.
+ */
+void canvas_flush() {
+  uint8_t open = 0;
+  for (uint8_t page = 0; page < CANVAS_PAGES; page++) {
+    uint8_t x = 0;
+    while (x < DISPLAY_WIDTH) {
+      if (!touched[page][x / 8]) {
+        x = (x / 8 + 1) * 8;  // Skip eight untouched columns at once
+        continue;
+      }
+      if (!is_touched(page, x)) {
+        x++;
+        continue;
+      }
+
+      // Extend the run across gaps cheaper than a new window
+      uint8_t start = x;
+      uint8_t end = x;
+      for (x++; x < DISPLAY_WIDTH && x - end <= WINDOW_COST; x++) {
+        if (is_touched(page, x)) {
+          end = x;
+        }
+      }
+      if (!open) {
+        sh1107_begin();
+        open = 1;
+      }
+      sh1107_window(firstPage + page, start);
+      sh1107_stream(&tile[page][start], end - start + 1);
+      x = end + 1;
+    }
+  }
+  if (open) {
+    sh1107_end();
+  }
+}
@@ -0,0 +1,21 @@
+/**
+ * @file canvas.h
+ * @brief Header file for the page-tile render buffer.
+ */
+
+#ifndef SNAKE_GAME_CANVAS_H
+#define SNAKE_GAME_CANVAS_H
+
+#include <stdint.h>
+
+void canvas_begin(uint8_t);
+
+void canvas_sprite_P(uint8_t, uint8_t, const uint8_t*, uint8_t);
+
+void canvas_hline(uint8_t, uint8_t, uint8_t);
+
+void canvas_touch(uint8_t, uint8_t, uint8_t);
+
+void canvas_flush();
+
+#endif
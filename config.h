@@ -13,19 +13,69 @@
 #define DC_PIN PB1   // D9
 #define RES_PIN PB0  // D8
 
-// Button Pins
-#define UP_BTN_PIN PD2     // D2
-#define DOWN_BTN_PIN PD3   // D3
-#define LEFT_BTN_PIN PD4   // D4
+// Display transport: SPI module (MOSI D11, SCK D13, fosc/16) or
+// USART0 in Master SPI mode (TXD0 D1, XCK0 D4, fosc/2, buffered TX)
+#define DISPLAY_TRANSPORT_SPI 0
+#define DISPLAY_TRANSPORT_USART 1
+#define DISPLAY_TRANSPORT DISPLAY_TRANSPORT_SPI
+
+// Button Pins (all on PORTD / PCINT2)
+#define UP_BTN_PIN PD2    // D2
+#define DOWN_BTN_PIN PD3  // D3
+#if DISPLAY_TRANSPORT == DISPLAY_TRANSPORT_USART
+#define LEFT_BTN_PIN PD6  // D6, D4 is XCK0 in USART SPI mode
+#else
+#define LEFT_BTN_PIN PD4  // D4
+#endif
 #define RIGHT_BTN_PIN PD5  // D5
 
-// Game Configuration
-#define GRID_SIZE 16
+// Second player buttons (all on PORTC / PCINT1, analog pins as inputs)
+#define P2_UP_BTN_PIN PC1     // A1
+#define P2_DOWN_BTN_PIN PC2   // A2
+#define P2_LEFT_BTN_PIN PC3   // A3
+#define P2_RIGHT_BTN_PIN PC4  // A4
+
+// Board Geometry: cells across, cells down and cell size in pixels, chosen
+// with -DGEOMETRY=... (make GEOMETRY=32X28). The play area fills the panel
+// below the score bar; geometry.h checks the fit and holds the tables.
+#define GEOMETRY_16X14 0  // 8 px cells, one row per display page
+#define GEOMETRY_32X28 1  // 4 px cells, two rows per display page
+#ifndef GEOMETRY
+#define GEOMETRY GEOMETRY_16X14
+#endif
+#if GEOMETRY == GEOMETRY_32X28
+#define GRID_WIDTH 32
+#define GRID_HEIGHT 28
+#define CELL_SIZE 4
+#define GRID_RING_SIZE 1024  // Power of two holding every cell
+#define GRID_MAX_SNAKES 1    // SRAM holds one 1024-link body only
+#else
+#define GRID_WIDTH 16
+#define GRID_HEIGHT 14
 #define CELL_SIZE 8
-#define MAX_SNAKE_LENGTH 50
-#define MOVE_DELAY 250
+#define GRID_RING_SIZE 256
+#define GRID_MAX_SNAKES 2
+#endif
+#define GRID_CELLS (GRID_WIDTH * GRID_HEIGHT)
+#define GRID_BYTES (GRID_CELLS / 8)
+
+// Game Configuration
+#define MAX_SNAKES GRID_MAX_SNAKES  // 2 allows two-player games
+#define SNAKE_BODY_PACKED 1  // 1 = 2-bit direction chain, 0 = Point ring
+#if SNAKE_BODY_PACKED
+#define MAX_SNAKE_LENGTH GRID_CELLS
+#define SNAKE_RING_SIZE GRID_RING_SIZE
+#else
+#define MAX_SNAKE_LENGTH 128
+#define SNAKE_RING_SIZE MAX_SNAKE_LENGTH  // Must be a power of two
+#endif
+#define SNAKE_INDEX_MASK (SNAKE_RING_SIZE - 1)
+#ifndef MOVE_DELAY
+#define MOVE_DELAY 250  // Milliseconds per tick (benchmarks build with less)
+#endif
 #define SCORE_AREA_HEIGHT 16
 #define PARTITION_LINE_Y (SCORE_AREA_HEIGHT - 1)
+#define CANVAS_PAGES 2  // Display pages composed in RAM at once, 128 B each
 
 // Snake moving directions
 #define DIRECTION_UP 3
@@ -36,9 +86,29 @@
 #define INITIAL_SCORE 0
 #define INITIAL_SNAKE_LENGTH 3
 #define INITIAL_DIRECTION DIRECTION_RIGHT
-#define INITIAL_SNAKE {{3, 4}, {2, 4}, {1, 4}}
+#define INITIAL_SNAKE_TAIL {1, 4}  // Grows toward INITIAL_DIRECTION
+#define INITIAL_SNAKE2_DIRECTION DIRECTION_LEFT  // Second snake, mirrored
+#define INITIAL_SNAKE2_TAIL {GRID_WIDTH - 2, GRID_HEIGHT - 5}
+
+// Random seed: ADC noise on a floating pin, unless RANDOM_SEED is defined
+#define RANDOM_ADC_CHANNEL 0  // A0, leave unconnected
+#define RANDOM_ADC_SAMPLES 16
 
 // Button Debouncing
 #define DEBOUNCE_TIME 50
+#define INPUT_QUEUE_SIZE 4  // Buffered turns, power of two
+
+// Input Recording
+#define REPLAY_CAPACITY 128    // Logged direction changes per game
+#define REPLAY_EEPROM_ADDR 0   // EEPROM offset of the saved recording
+
+// High Scores and Settings
+#define STORE_EEPROM_ADDR 512  // Wear-levelled slots from here...
+#define STORE_EEPROM_SIZE 512  // ...to the end of the 1 KB EEPROM
+#define HIGH_SCORE_COUNT 5
+#define MOVE_DELAY_MIN 100  // Speed setting range and step, in ms per tick
+#define MOVE_DELAY_MAX 400
+#define MOVE_DELAY_STEP 25
+#define CONTRAST_STEP 0x20
 
 #endif
\ No newline at end of file
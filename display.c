@@ -2,11 +2,12 @@
  * @file display.c
  * @brief SH1107 OLED display driver (AVR-compatible).
  */
-#include <avr/io.h>
-#include <util/delay.h>
+#include <avr/pgmspace.h>
 
 #include "config.h"
 #include "display.h"
+#include "hal.h"
+#include "probe.h"
 #include "serial.h"
 
 /**
@@ -14,59 +15,81 @@
  * @param cmd The command byte to send.
  */
 void sh1107_command(uint8_t cmd) {
-  PORTB &= ~(1 << DC_PIN);  // DC low for command mode
-  PORTB &= ~(1 << CS_PIN);  // CS low to enable SPI
-  spi_write(cmd);           // Transmit command
-  PORTB |= (1 << CS_PIN);   // CS high to end transaction
+  spi_command(cmd);  // Queue command (DC low)
 }
 
 /**
- * @brief Sends a data byte to the SH1107 display for pixel rendering.
- * @param y The vertical position (0-127) to target.
+ * @brief Opens a display transaction; CS stays low until sh1107_end().
  */
-void sh1107_data(uint8_t y) {
-  uint8_t page_mask = 1 << (y % PAGE_HEIGHT);  // Convert Y to page bitmask
-  PORTB |= (1 << DC_PIN);                      // DC high for data mode
-  PORTB &= ~(1 << CS_PIN);                     // CS low to enable SPI
-  spi_write(page_mask);                        // Transmit pixel data
-  PORTB |= (1 << CS_PIN);                      // CS high to end transaction
+void sh1107_begin() {
+  spi_begin();
 }
 
 /**
- * @brief Clears the entire display buffer (sets all pixels to off).
+ * @brief Points subsequent data bytes at a page and starting column.
+ * @param page The page number (8-pixel row group) to target.
+ * @param x The starting horizontal position (0-127).
+ * @note The column advances after every data byte, so the window's width
+ * is simply the number of bytes streamed next.
  */
-void sh1107_clean() {
-  PORTB |= (1 << DC_PIN);   // DC high for data mode
-  PORTB &= ~(1 << CS_PIN);  // CS low to enable SPI
-  spi_write(0);             // Write 0 to clear pixels
-  PORTB |= (1 << CS_PIN);   // CS high to end transaction
+void sh1107_window(uint8_t page, uint8_t x) {
+  spi_command(SH1107_SET_PAGE_ADDR + page);
+  spi_command(SH1107_SET_LOW_COL_ADDR + (x & 0x0F));
+  spi_command(SH1107_SET_HIGH_COL_ADDR + ((x & 0xF0) >> 4));
 }
 
 /**
- * @brief Sets the target page (8-pixel row group) for subsequent writes.
- * @param y The vertical position (0-127) to determine the page.
+ * @brief Streams column bytes into the current window.
+ * @param data Column bytes to transmit (bit n = row n of the page).
+ * @param len Number of bytes to transmit.
  */
-void sh1107_page(uint8_t y) {
-  uint8_t page = y / PAGE_HEIGHT;  // Convert Y coordinate to page number
-  sh1107_command(SH1107_SET_PAGE_ADDR + page);
+void sh1107_stream(const uint8_t* data, uint16_t len) {
+  for (uint16_t i = 0; i < len; i++) {
+    spi_write(data[i]);
+  }
 }
 
 /**
- * @brief Sets the lower nibble of the column address for pixel positioning.
- * @param x The horizontal position (0-127), lower 4 bits used.
+ * @brief Streams the same column byte repeatedly into the current window.
+ * @param value Column byte to repeat.
+ * @param len Number of bytes to transmit.
  */
-void sh1107_lowcol(uint8_t x) {
-  uint8_t low_nibble = (x & 0x0F);  // Extract lower 4 bits
-  sh1107_command(SH1107_SET_LOW_COL_ADDR + low_nibble);
+void sh1107_fill(uint8_t value, uint16_t len) {
+  for (uint16_t i = 0; i < len; i++) {
+    spi_write(value);
+  }
 }
 
 /**
- * @brief Sets the higher nibble of the column address for pixel positioning.
- * @param x The horizontal position (0-127), upper 4 bits used.
+ * @brief Closes a display transaction; CS rises once the queue drains.
  */
-void sh1107_highcol(uint8_t x) {
-  uint8_t high_nibble = ((x & 0xF0) >> 4);  // Extract upper 4 bits
-  sh1107_command(SH1107_SET_HIGH_COL_ADDR + high_nibble);
+void sh1107_end() {
+  spi_end();
+}
+
+/**
+ * @brief Writes a run of column bytes into one page in a single transaction.
+ * @param page The page number (8-pixel row group) to target.
+ * @param x The starting horizontal position (0-127).
+ * @param data Column bytes to transmit (bit n = row n of the page).
+ * @param len Number of bytes to transmit.
+ */
+void sh1107_block(uint8_t page, uint8_t x, const uint8_t* data, uint8_t len) {
+  sh1107_begin();
+  sh1107_window(page, x);
+  sh1107_stream(data, len);
+  sh1107_end();
+}
+
+/**
+ * @brief Changes the display contrast.
+ * @param contrast Contrast value (0-255), SH1107_CONTRAST_DEFAULT at init.
+ */
+void sh1107_set_contrast(uint8_t contrast) {
+  sh1107_begin();
+  spi_command(SH1107_SET_CONTRAST);
+  spi_command(contrast);
+  sh1107_end();
 }
 
 /**
@@ -74,38 +97,26 @@ void sh1107_highcol(uint8_t x) {
  * Performs hardware reset and configures display parameters:
  * - Clock divider, multiplex ratio, charge pump, addressing mode.
  * - Contrast, precharge, VCOMH, and display state.
+ * @note Requires global interrupts; the init sequence drains via the SPI ISR.
  */
 void sh1107_init() {
-  // Hardware reset
-  PORTB &= ~(1 << RES_PIN);
-  _delay_ms(DISPLAY_INIT_DELAY_MS);
-  PORTB |= (1 << RES_PIN);
-  _delay_ms(DISPLAY_INIT_DELAY_MS);
+  PROBE_ENTER(PROBE_SH1107_INIT);
+
+  // Hardware reset (bus must be idle while RES is toggled)
+  spi_flush();
+  hal_display_reset(1);
+  hal_delay_ms(DISPLAY_INIT_DELAY_MS);
+  hal_display_reset(0);
+  hal_delay_ms(DISPLAY_INIT_DELAY_MS);
+
+  // Init sequence, played back from flash in one transaction
+  static const uint8_t init_sequence[] PROGMEM = SH1107_INIT_SEQUENCE;
+  sh1107_begin();
+  for (uint8_t i = 0; i < sizeof(init_sequence); i++) {
+    spi_command(pgm_read_byte(&init_sequence[i]));
+  }
+  sh1107_end();
+  spi_flush();
 
-  // Init sequence
-  sh1107_command(SH1107_DISPLAY_OFF);
-  sh1107_command(SH1107_SET_CLOCK_DIV);
-  sh1107_command(SH1107_CLOCK_DIV_DEFAULT);
-  sh1107_command(SH1107_SET_MULTIPLEX_RATIO);
-  sh1107_command(SH1107_MULTIPLEX_128);
-  sh1107_command(SH1107_SET_DISPLAY_OFFSET);
-  sh1107_command(SH1107_OFFSET_NONE);
-  sh1107_command(SH1107_SET_START_LINE);
-  sh1107_command(SH1107_CHARGE_PUMP_CTRL);
-  sh1107_command(SH1107_CHARGE_PUMP_ENABLE);
-  sh1107_command(SH1107_SET_ADDRESS_MODE);
-  sh1107_command(SH1107_ADDRESS_MODE_HORIZ);
-  sh1107_command(SH1107_SET_SEGMENT_REMAP);
-  sh1107_command(SH1107_SET_COM_SCAN_DIR);
-  sh1107_command(SH1107_SET_COM_PINS);
-  sh1107_command(SH1107_COM_PINS_ALT);
-  sh1107_command(SH1107_SET_CONTRAST);
-  sh1107_command(SH1107_CONTRAST_DEFAULT);
-  sh1107_command(SH1107_SET_PRECHARGE);
-  sh1107_command(SH1107_PRECHARGE_DEFAULT);
-  sh1107_command(SH1107_SET_VCOMH_DESELECT);
-  sh1107_command(SH1107_VCOMH_DEFAULT);
-  sh1107_command(SH1107_SET_ENTIRE_DISPLAY);
-  sh1107_command(SH1107_SET_NORMAL_DISPLAY);
-  sh1107_command(SH1107_DISPLAY_ON);
+  PROBE_LEAVE(PROBE_SH1107_INIT);
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #define DISPLAY_WIDTH 128
+#define DISPLAY_HEIGHT 128
 #define PAGE_HEIGHT 8
 #define DISPLAY_INIT_DELAY_MS 10
 
@@ -70,17 +71,39 @@
 #define SH1107_SET_ENTIRE_DISPLAY 0xA4  // Pixels follow RAM
 #define SH1107_SET_NORMAL_DISPLAY 0xA6  // Non-inverted (0xA7 = inverted)
 
+#define SH1107_INIT_SEQUENCE                           \
+  {SH1107_DISPLAY_OFF,                                 \
+   SH1107_SET_CLOCK_DIV, SH1107_CLOCK_DIV_DEFAULT,     \
+   SH1107_SET_MULTIPLEX_RATIO, SH1107_MULTIPLEX_128,   \
+   SH1107_SET_DISPLAY_OFFSET, SH1107_OFFSET_NONE,      \
+   SH1107_SET_START_LINE,                              \
+   SH1107_CHARGE_PUMP_CTRL, SH1107_CHARGE_PUMP_ENABLE, \
+   SH1107_SET_ADDRESS_MODE, SH1107_ADDRESS_MODE_HORIZ, \
+   SH1107_SET_SEGMENT_REMAP,                           \
+   SH1107_SET_COM_SCAN_DIR,                            \
+   SH1107_SET_COM_PINS, SH1107_COM_PINS_ALT,           \
+   SH1107_SET_CONTRAST, SH1107_CONTRAST_DEFAULT,       \
+   SH1107_SET_PRECHARGE, SH1107_PRECHARGE_DEFAULT,     \
+   SH1107_SET_VCOMH_DESELECT, SH1107_VCOMH_DEFAULT,    \
+   SH1107_SET_ENTIRE_DISPLAY,                          \
+   SH1107_SET_NORMAL_DISPLAY,                          \
+   SH1107_DISPLAY_ON}
+
 void sh1107_command(uint8_t);
 
-void sh1107_data(uint8_t);
+void sh1107_begin();
+
+void sh1107_window(uint8_t, uint8_t);
+
+void sh1107_stream(const uint8_t*, uint16_t);
 
-void sh1107_clean();
+void sh1107_fill(uint8_t, uint16_t);
 
-void sh1107_page(uint8_t);
+void sh1107_end();
 
-void sh1107_lowcol(uint8_t);
+void sh1107_block(uint8_t, uint8_t, const uint8_t*, uint8_t);
 
-void sh1107_highcol(uint8_t);
+void sh1107_set_contrast(uint8_t);
 
 void sh1107_init();
 
@@ -3,153 +3,194 @@
  * @brief Core game logic for Snake game implementation.
  */
 
-#include <stdlib.h>
 #include "config.h"
 #include "display.h"
 #include "graphic.h"
+#include "grid.h"
+#include "level.h"
+#include "probe.h"
+#include "random.h"
+#include "snake.h"
 #include "types.h"
 
+#if SNAKE_RING_SIZE & SNAKE_INDEX_MASK || SNAKE_RING_SIZE < MAX_SNAKE_LENGTH
+#error "SNAKE_RING_SIZE must be a power of two holding MAX_SNAKE_LENGTH"
+#endif
+
+#if MAX_SNAKES < 1 || MAX_SNAKES > 2
+#error "MAX_SNAKES must be 1 or 2"
+#endif
+
 /**
  * @brief Renders the complete game state on the display.
  * @param state Pointer to the current GameState structure.
+ * @note Only cells that changed since the last frame are staged and sent
+ * to the display.
  */
 void render_game(GameState* state) {
-  clear_play_area();
-  draw_horizontal_line(PARTITION_LINE_Y);
+  PROBE_ENTER(PROBE_RENDER_GAME);
   draw_snake(state);
   draw_food(state);
-  draw_score(&(state->score));
+  flush_frame();
+  for (uint8_t i = 0; i < state->snakeCount; i++) {
+    draw_score(i, &(state->snakes[i].score));
+  }
+  PROBE_LEAVE(PROBE_RENDER_GAME);
 }
 
 /**
  * @brief Places food at a random valid position on the grid.
  * @param state Pointer to the current GameState structure.
- * @note Ensures food doesn't spawn on snake segments.
+ * @note Picks the k-th free cell of the occupancy bitmap, so food never
+ * spawns on snake segments and no retries are needed.
  */
 void place_food(GameState* state) {
-  uint8_t valid = 0;
-  while (!valid) {
-    state->food.x = rand() % GRID_SIZE;
-    state->food.y = rand() % GRID_SIZE;
-    valid = 1;
-    for (uint8_t i = 0; i < state->snakeLength; i++) {
-      if (state->snake[i].x == state->food.x &&
-          state->snake[i].y == state->food.y) {
-        valid = 0;
-        break;
-      }
-    }
+  PROBE_ENTER(PROBE_PLACE_FOOD);
+  uint16_t freeCells = GRID_CELLS - state->occupancy.used;
+  if (freeCells > 0) {
+    state->food = grid_free_cell(&(state->occupancy),
+                                 random_range(&(state->rng), freeCells));
   }
+  PROBE_LEAVE(PROBE_PLACE_FOOD);
 }
 
 /**
- * @brief Calculates the snake's new head position based on current direction.
- * @param state Pointer to the current GameState structure.
+ * @brief Calculates a snake's new head position based on its direction.
+ * @param snake Pointer to the Snake to move.
  * @return Point structure containing the new head coordinates.
- * @note Implements screen wrapping via modulo operation.
+ * @note Wrapping at the borders is handled by snake_step.
  */
-Point calculate_new_head(GameState* state) {
-  Point newHead = state->snake[0];
-
-  switch (*(state->direction)) {
-    case DIRECTION_RIGHT:
-      newHead.x++;
-      break;
-    case DIRECTION_DOWN:
-      newHead.y++;
-      break;
-    case DIRECTION_LEFT:
-      newHead.x--;
-      break;
-    case DIRECTION_UP:
-      newHead.y--;
-      break;
-  }
-
-  // Wrap around boundaries
-  newHead.x %= GRID_SIZE;
-  newHead.y %= GRID_SIZE;
-
-  return newHead;
+Point calculate_new_head(const Snake* snake) {
+  return snake_step(snake_head(snake), *(snake->direction));
 }
 
 /**
- * @brief Checks if new head position collides with snake body.
+ * @brief Checks if new head position collides with any snake's body.
  * @param state Pointer to the current GameState structure.
  * @param newHead Proposed new head position to check.
- * @return 1 if collision detected, 0 otherwise.
+ * @return Non-zero if collision detected, 0 otherwise.
+ * @note One lookup in the shared grid, whatever the number of snakes.
  */
 uint8_t check_collision(GameState* state, Point newHead) {
-  for (uint8_t i = 1; i < state->snakeLength; i++) {
-    if (state->snake[i].x == newHead.x && state->snake[i].y == newHead.y) {
-      return 1;
-    }
-  }
-  return 0;
+  return grid_test(&(state->occupancy), newHead);
 }
 
 /**
  * @brief Handles food consumption and score updates.
  * @param state Pointer to the current GameState structure.
+ * @param snake Pointer to the Snake whose head moved.
  * @param newHead Current head position to check against food.
+ * @note Must run after every head is marked so food avoids them.
  */
-void handle_food_check(GameState* state, Point newHead) {
+void handle_food_check(GameState* state, Snake* snake, Point newHead) {
   if (newHead.x == state->food.x && newHead.y == state->food.y) {
-    if (state->snakeLength < MAX_SNAKE_LENGTH) {
-      state->snakeLength++;
-    }
-    state->score++;
+    snake->score++;
     place_food(state);
   }
 }
 
 /**
- * @brief Moves all snake body segments forward.
+ * @brief Moves one snake to its checked new head.
  * @param state Pointer to the current GameState structure.
- * @note Shifts each segment to the position of the preceding segment.
+ * @param snake Pointer to the Snake to move.
+ * @param newHead Free cell next to the head.
  */
-void move_snake_body(GameState* state) {
-  for (uint8_t i = state->snakeLength - 1; i > 0; i--) {
-    state->snake[i] = state->snake[i - 1];
+static void advance(GameState* state, Snake* snake, Point newHead) {
+  uint8_t ateFood = (newHead.x == state->food.x && newHead.y == state->food.y);
+  if (ateFood && snake->length < MAX_SNAKE_LENGTH) {
+    snake->length++;  // Growing skips the tail pop
+  } else {
+    grid_unmark(&(state->occupancy), snake_tail(snake));
+    snake_pop(snake);
   }
+  snake_push(snake, *(snake->direction));
+  grid_mark(&(state->occupancy), newHead);
 }
 
 /**
  * @brief Coordinates complete snake movement and collision handling.
  * @param state Pointer to the current GameState structure.
- * @note Sets gameOver flag if collision occurs with body.
+ * @note Sets gameOver flag if any head hits a body or two heads meet; no
+ * snake moves on that tick.
+ * @note Constant time per snake: one grid lookup, one body push and at
+ * most one body pop. Heads are compared pairwise, never with bodies, and
+ * snakes swapping places each hit the other's old head in the grid.
  */
 void move_snake(GameState* state) {
-  Point newHead = calculate_new_head(state);
-
-  if (check_collision(state, newHead)) {
-    state->gameOver = 1;
+  PROBE_ENTER(PROBE_MOVE_SNAKE);
+  Point newHeads[MAX_SNAKES];
+  for (uint8_t i = 0; i < state->snakeCount; i++) {
+    newHeads[i] = calculate_new_head(&(state->snakes[i]));
+    if (check_collision(state, newHeads[i])) {
+      state->gameOver = 1;
+    }
+    for (uint8_t j = 0; j < i; j++) {
+      if (newHeads[i].x == newHeads[j].x && newHeads[i].y == newHeads[j].y) {
+        state->gameOver = 1;
+      }
+    }
+  }
+  if (state->gameOver) {
+    PROBE_LEAVE(PROBE_MOVE_SNAKE);
     return;
   }
 
-  uint8_t ateFood = (newHead.x == state->food.x && newHead.y == state->food.y);
-  handle_food_check(state, newHead);
-
-  if (!ateFood) {
-    move_snake_body(state);
+  for (uint8_t i = 0; i < state->snakeCount; i++) {
+    advance(state, &(state->snakes[i]), newHeads[i]);
   }
+  for (uint8_t i = 0; i < state->snakeCount; i++) {
+    handle_food_check(state, &(state->snakes[i]), newHeads[i]);
+  }
+  PROBE_LEAVE(PROBE_MOVE_SNAKE);
+}
 
-  state->snake[0] = newHead;
+/**
+ * @brief Lays a snake out at its start position.
+ * @param state Pointer to the current GameState structure.
+ * @param snake Pointer to the Snake to reset.
+ * @param tail Cell of the last segment.
+ * @param direction Direction the snake grows and starts moving in.
+ */
+static void spawn(GameState* state, Snake* snake, Point tail,
+                  uint8_t direction) {
+  *(snake->direction) = direction;
+  snake->score = INITIAL_SCORE;
+  grid_mark(&(state->occupancy), tail);
+  snake_reset(snake, tail);
+  for (uint8_t i = 1; i < INITIAL_SNAKE_LENGTH; i++) {
+    snake_push(snake, direction);
+    grid_mark(&(state->occupancy), snake_head(snake));
+  }
+  snake->length = INITIAL_SNAKE_LENGTH;
 }
 
 /**
  * @brief Resets game state to initial conditions.
  * @param state Pointer to the GameState structure to reset.
- * @note Reinitializes snake position, score, and spawns new food.
+ * @note Reinitializes snake positions, scores, and spawns new food. Set
+ * snakeCount, level and every snake's direction latch first.
+ * @note The level's walls are loaded into the occupancy grid, so hitting
+ * one is an ordinary collision and food never lands on one.
+ * @note This is the only place the play area, its walls and the score
+ * label are fully repainted.
  */
 void reset_game(GameState* state) {
-  state->direction = INITIAL_DIRECTION;
-  state->score = INITIAL_SCORE;
+  const uint8_t* walls = level_walls(state->level);
   state->gameOver = 0;
-  state->snake = (Point[MAX_SNAKE_LENGTH])INITIAL_SNAKE;
+  grid_load_P(&(state->occupancy), walls);
+
+  Point tail = INITIAL_SNAKE_TAIL;
+  spawn(state, &(state->snakes[0]), tail, INITIAL_DIRECTION);
+#if MAX_SNAKES > 1
+  if (state->snakeCount > 1) {
+    Point tail2 = INITIAL_SNAKE2_TAIL;
+    spawn(state, &(state->snakes[1]), tail2, INITIAL_SNAKE2_DIRECTION);
+  }
+#endif
 
   place_food(state);
-  draw_score(&(state->score));
-  draw_horizontal_line(PARTITION_LINE_Y);
+  clear_play_area();
+  draw_walls(walls);
+  draw_score_label(state->snakeCount);
   render_game(state);
-}
\ No newline at end of file
+}
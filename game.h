@@ -12,11 +12,11 @@ void render_game(GameState*);
 
 void place_food(GameState*);
 
-uint8_t check_collision(GameState*);
+uint8_t check_collision(GameState*, Point);
 
-Point calculate_new_head(GameState*);
+Point calculate_new_head(const Snake*);
 
-void handle_food_check(GameState*, Point);
+void handle_food_check(GameState*, Snake*, Point);
 
 void move_snake(GameState*);
 
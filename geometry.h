@@ -0,0 +1,76 @@
+/**
+ * @file geometry.h
+ * @brief Board geometry checks and lookup tables for every GEOMETRY_*
+ * preset in config.h.
+ * @note Generated by tools/gen_geometry.py (make geometry); do not edit.
+ * Tables are indexed by cell row or column:
+ * - GEOMETRY_ROW_PAGE: display page holding the row
+ * - GEOMETRY_ROW_Y: top pixel row of the row
+ * - GEOMETRY_COLUMN_X: left pixel column of the column
+ * - GEOMETRY_WRAP_X/Y: indexed by coordinate + 1, so -1 and the size
+ *   itself wrap to the opposite border
+ */
+
+#ifndef SNAKE_GAME_GEOMETRY_H
+#define SNAKE_GAME_GEOMETRY_H
+
+#include "config.h"
+#include "display.h"
+
+#if GRID_WIDTH * CELL_SIZE > DISPLAY_WIDTH || \
+    SCORE_AREA_HEIGHT + GRID_HEIGHT * CELL_SIZE > DISPLAY_HEIGHT
+#error "The play area does not fit below the score bar"
+#endif
+
+#if PAGE_HEIGHT % CELL_SIZE || SCORE_AREA_HEIGHT % PAGE_HEIGHT
+#error "Grid cells must line up with SH1107 pages"
+#endif
+
+#if GRID_WIDTH % 8 || GRID_WIDTH > 32 || GRID_HEIGHT % 2 || GRID_HEIGHT > 32
+#error "Grid width must be 8, 16, 24 or 32 and its height even, at most 32"
+#endif
+
+#define ROWS_PER_PAGE (PAGE_HEIGHT / CELL_SIZE)
+
+#if GEOMETRY == GEOMETRY_16X14
+#if GRID_WIDTH != 16 || GRID_HEIGHT != 14 || CELL_SIZE != 8 || \
+    SCORE_AREA_HEIGHT != 16
+#error "geometry.h does not match config.h, run make geometry"
+#endif
+#define GEOMETRY_ROW_PAGE {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}
+#define GEOMETRY_ROW_Y                                        \
+  {16, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120}
+#define GEOMETRY_COLUMN_X                                           \
+  {0, 8, 16, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120}
+#define GEOMETRY_WRAP_X                                         \
+  {15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0}
+#define GEOMETRY_WRAP_Y {13, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 0}
+#endif
+
+#if GEOMETRY == GEOMETRY_32X28
+#if GRID_WIDTH != 32 || GRID_HEIGHT != 28 || CELL_SIZE != 4 || \
+    SCORE_AREA_HEIGHT != 16
+#error "geometry.h does not match config.h, run make geometry"
+#endif
+#define GEOMETRY_ROW_PAGE                                                  \
+  {2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, \
+   13, 13, 14, 14, 15, 15}
+#define GEOMETRY_ROW_Y                                                     \
+  {16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60, 64, 68, 72, 76, 80, 84, \
+   88, 92, 96, 100, 104, 108, 112, 116, 120, 124}
+#define GEOMETRY_COLUMN_X                                                   \
+  {0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60, 64, 68, 72, \
+   76, 80, 84, 88, 92, 96, 100, 104, 108, 112, 116, 120, 124}
+#define GEOMETRY_WRAP_X                                                      \
+  {31, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, \
+   20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 0}
+#define GEOMETRY_WRAP_Y                                                      \
+  {27, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, \
+   20, 21, 22, 23, 24, 25, 26, 27, 0}
+#endif
+
+#ifndef GEOMETRY_ROW_Y
+#error "No lookup tables for this GEOMETRY, add it to tools/gen_geometry.py"
+#endif
+
+#endif
@@ -3,74 +3,80 @@
  * @brief Graphics rendering functions for SH1107 OLED display.
  */
 
+#include <avr/pgmspace.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <util/delay.h>
+#include <string.h>
+#include "canvas.h"
 #include "config.h"
 #include "display.h"
 #include "font.h"
+#include "geometry.h"
+#include "probe.h"
+#include "snake.h"
+#include "sprite.h"
 #include "types.h"
 
-/**
- * @brief Draws a single pixel at specified coordinates.
- * @param x Horizontal position (0-127).
- * @param y Vertical position (0-63).
- */
-void draw_pixel(uint8_t x, uint8_t y) {
-  sh1107_page(y);
-  sh1107_lowcol(x);
-  sh1107_highcol(x);
-  sh1107_data(y);
-}
+#define TILE_BITS 2
+#define TILE_MASK 0x03
+#define TILES_PER_BYTE (8 / TILE_BITS)
+#define FRAME_BYTES (GRID_CELLS / TILES_PER_BYTE)
+#define ROW_BYTES (GRID_WIDTH / TILES_PER_BYTE)
+#define CANVAS_ROWS (CANVAS_PAGES * ROWS_PER_PAGE)  // Cell rows per canvas
 
-/**
- * @brief Clears an entire display page (8-pixel row group).
- * @param x Starting horizontal position (0-127).
- * @param page Page number (0-7 for 64px display).
- */
-void clear_page(uint8_t x, uint8_t page) {
-  sh1107_page(page);
-  sh1107_lowcol(x);
-  sh1107_highcol(x);
-  sh1107_clean(0);
-}
+#if GRID_HEIGHT <= 16
+typedef uint16_t RowMask;  // One bit per cell row
+#else
+typedef uint32_t RowMask;
+#endif
 
-/**
- * @brief Draws a horizontal line across the display.
- * @param y Vertical position for the line (0-63).
- */
-void draw_horizontal_line(uint8_t y) {
-  for (uint8_t x = 0; x < 128; x++) {
-    draw_pixel(x, y);
-  }
-}
+#if GRID_WIDTH <= 16
+typedef uint16_t ColumnMask;  // One bit per cell column
+#else
+typedef uint32_t ColumnMask;
+#endif
+
+#define SCORE_LABEL "SCORE:"
+#define PLAYER_LABEL "P1:"  // Two players: digit bumped for the second
+#define SCORE_DIGITS 5      // Enough for any uint16_t
+#define SCORE_PAGES (SCORE_AREA_HEIGHT / PAGE_HEIGHT)
+
+static const uint8_t font[][FONT_WIDTH] PROGMEM = FONT;
+static const uint8_t sprites[][SPRITE_WIDTH] PROGMEM = SPRITES;
+static const uint8_t wall[SPRITE_WIDTH] PROGMEM = SPRITE_WALL;
+static const uint8_t rowPage[GRID_HEIGHT] PROGMEM = GEOMETRY_ROW_PAGE;
+static const uint8_t rowY[GRID_HEIGHT] PROGMEM = GEOMETRY_ROW_Y;
+static const uint8_t columnX[GRID_WIDTH] PROGMEM = GEOMETRY_COLUMN_X;
+
+static uint8_t frame[FRAME_BYTES];   // Tiles staged for the next frame
+static uint8_t shadow[FRAME_BYTES];  // Tiles currently shown on the display
+static RowMask dirtyRows = 0;        // Rows whose staged tiles changed
+static uint8_t snakeDrawn = 0;       // Frame holds the whole snakes
+static const uint8_t* walls = NULL;  // Wall map in flash, Grid order
+static Point drawnHead[MAX_SNAKES];  // Head and tail cells staged last
+static Point drawnTail[MAX_SNAKES];
+
+typedef struct {
+  uint16_t value;                // Score held in digits
+  uint8_t digits[SCORE_DIGITS];  // Decimal digits, least first
+  uint8_t count;                 // Digits in use, 0 before the first draw
+  char shown[SCORE_DIGITS];      // Characters on the display
+  uint8_t x;                     // Column of the first digit
+} ScoreWidget;
+
+static ScoreWidget scores[MAX_SNAKES];  // One per player
 
 /**
  * @brief Maps ASCII characters to font array indices.
  * @param c Character to look up.
- * @return Font array index (255 for invalid characters).
+ * @return Font array index; characters outside FONT_FIRST..FONT_LAST map
+ * to FONT_FALLBACK.
  */
 uint8_t get_char_index(char c) {
-  if (c >= '0' && c <= '9') {
-    return c - '0';
-  } else {
-    switch (c) {
-      case 'S':
-        return CHAR_S_INDEX;
-      case 'C':
-        return CHAR_C_INDEX;
-      case 'O':
-        return CHAR_O_INDEX;
-      case 'R':
-        return CHAR_R_INDEX;
-      case 'E':
-        return CHAR_E_INDEX;
-      case ':':
-        return CHAR_COLON_INDEX;
-      default:
-        return CHAR_INVALID_INDEX;
-    }
+  if (c < FONT_FIRST || c > FONT_LAST) {
+    c = FONT_FALLBACK;
   }
+  return c - FONT_FIRST;
 }
 
 /**
@@ -80,139 +86,293 @@ uint8_t get_char_index(char c) {
  * @param c Character to draw.
  */
 void draw_char(uint8_t x, uint8_t y, char c) {
-  static const uint8_t font[][5] = FONT;
   uint8_t char_index = get_char_index(c);
+  uint8_t columns[FONT_WIDTH];
 
-  for (uint8_t col = 0; col < 5; col++) {
-    uint8_t c_page = font[char_index][col];
-    sh1107_page(y);
-    sh1107_lowcol(x + col);
-    sh1107_highcol(x + col);
-    sh1107_data(c_page << (y % 8));
+  for (uint8_t col = 0; col < FONT_WIDTH; col++) {
+    columns[col] = pgm_read_byte(&font[char_index][col]) << (y % PAGE_HEIGHT);
   }
+  sh1107_block(y / PAGE_HEIGHT, x, columns, FONT_WIDTH);
 }
 
 /**
- * @brief Clears the score display area (top page).
+ * @brief Redraws the score area: the labels and the partition line.
+ * @param players Number of scores shown, 1 to MAX_SNAKES.
+ * @note Composed on the canvas, one transaction per CANVAS_PAGES pages.
+ * One player gets SCORE_LABEL; two get PLAYER_LABEL each, the second at
+ * half width. Every digit counts as blank afterwards, so the next
+ * draw_score() paints the whole number.
  */
-void clear_score_area() {
-  for (uint8_t x = 0; x < 128; x++) {
-    clear_page(x, 0);
+void draw_score_label(uint8_t players) {
+  for (uint8_t page = 0; page < SCORE_PAGES; page += CANVAS_PAGES) {
+    canvas_begin(page);
+    for (uint8_t slot = 0; slot < players; slot++) {
+      ScoreWidget* widget = &scores[slot];
+      widget->x = slot * (DISPLAY_WIDTH / 2);
+      for (const char* c = players > 1 ? PLAYER_LABEL : SCORE_LABEL; *c; c++) {
+        char label = (*c == '1') ? '1' + slot : *c;
+        canvas_sprite_P(widget->x, 0, font[get_char_index(label)],
+                        FONT_WIDTH);
+        widget->x += FONT_ADVANCE;
+      }
+    }
+    canvas_hline(0, DISPLAY_WIDTH - 1, PARTITION_LINE_Y);
+    for (uint8_t i = page; i < page + CANVAS_PAGES && i < SCORE_PAGES; i++) {
+      canvas_touch(0, DISPLAY_WIDTH - 1, i * PAGE_HEIGHT);
+    }
+    canvas_flush();
+  }
+  for (uint8_t slot = 0; slot < MAX_SNAKES; slot++) {
+    memset(scores[slot].shown, ' ', SCORE_DIGITS);
   }
 }
 
 /**
- * @brief Draws a text label at specified coordinates.
- * @param x Horizontal starting position (0-127).
- * @param y Vertical starting position (0-63).
- * @param label Null-terminated string to draw.
- * @return Ending x-position after drawn text.
+ * @brief Updates the digits of a score display that changed.
+ * @param slot Player whose score is shown, below the draw_score_label()
+ * player count.
+ * @param score Pointer to current score value.
+ * @note Decimal digits are kept between calls. An increment by one is a
+ * carry through the digits; only other changes (a reset) divide. Each
+ * changed digit is one burst; an unchanged score sends nothing.
  */
-uint8_t draw_label(uint8_t x, uint8_t y, const char* label) {
-  uint8_t label_length = 0;
-  for (uint8_t i = 0; label[i] != '\0'; i++) {
-    label_length += x + i * FONT_WIDTH;
-    draw_char(label_length, y, label[i]);
+void draw_score(uint8_t slot, uint16_t* score) {
+  PROBE_ENTER(PROBE_DRAW_SCORE);
+  ScoreWidget* widget = &scores[slot];
+  uint16_t value = *score;
+  if (value == widget->value + 1) {
+    uint8_t i = 0;
+    while (i < widget->count && widget->digits[i] == 9) {
+      widget->digits[i++] = 0;
+    }
+    if (i == widget->count) {
+      widget->digits[widget->count++] = 1;
+    } else {
+      widget->digits[i]++;
+    }
+  } else if (value != widget->value || !widget->count) {
+    widget->count = 0;
+    uint16_t rest = value;
+    do {
+      widget->digits[widget->count++] = rest % 10;
+      rest /= 10;
+    } while (rest);
+  }
+  widget->value = value;
+
+  // Left-aligned: position 0 shows the most significant digit
+  for (uint8_t i = 0; i < SCORE_DIGITS; i++) {
+    char c = i < widget->count ? '0' + widget->digits[widget->count - 1 - i]
+                               : ' ';
+    if (c != widget->shown[i]) {
+      draw_char(widget->x + i * FONT_ADVANCE, 0, c);
+      widget->shown[i] = c;
+    }
   }
-  return label_length;
+  PROBE_LEAVE(PROBE_DRAW_SCORE);
 }
 
 /**
- * @brief Draws/updates the score display.
- * @param score Pointer to current score value.
+ * @brief Clears the game play area (below partition line).
+ * @note Also resets the staged and shadow grids, so the next draw_snake()
+ * stages the whole snake and the next flush repaints it.
+ */
+void clear_play_area() {
+  sh1107_begin();
+  for (uint8_t y = 0; y < GRID_HEIGHT; y += ROWS_PER_PAGE) {
+    sh1107_window(pgm_read_byte(&rowPage[y]), 0);
+    sh1107_fill(0, GRID_WIDTH * CELL_SIZE);
+  }
+  sh1107_end();
+  memset(frame, 0, FRAME_BYTES);
+  memset(shadow, 0, FRAME_BYTES);
+  dirtyRows = 0;
+  snakeDrawn = 0;
+}
+
+#if ROWS_PER_PAGE > 1
+/**
+ * @brief Tests the wall map for a cell.
+ * @param cell Cell index (y * GRID_WIDTH + x).
+ * @return Non-zero for a wall.
+ */
+static uint8_t is_wall(uint16_t cell) {
+  return walls && (pgm_read_byte(&walls[cell / 8]) >> (cell % 8)) & 1;
+}
+#endif
+
+/**
+ * @brief Draws the walls of a level into the cleared play area.
+ * @param map Wall map in program memory (see level_walls()).
+ * @note Composed on the canvas, one transaction per CANVAS_PAGES pages
+ * and only the wall columns are sent, so the open level costs nothing.
+ * Walls never become tiles: the staged and shadow grids keep them empty
+ * and no move ever stages them again.
  */
-void draw_score(uint16_t* score) {
-  clear_score_area();
-  uint8_t nextx = draw_label(0, 0, "SCORE:");
+void draw_walls(const uint8_t* map) {
+  walls = map;
+  for (uint8_t first = 0; first < GRID_HEIGHT; first += CANVAS_ROWS) {
+    canvas_begin(pgm_read_byte(&rowPage[first]));
+    for (uint8_t y = first; y < first + CANVAS_ROWS && y < GRID_HEIGHT; y++) {
+      uint8_t top = pgm_read_byte(&rowY[y]);
+      for (uint8_t x = 0; x < GRID_WIDTH; x += 8) {
+        uint8_t bits = pgm_read_byte(&map[(y * GRID_WIDTH + x) / 8]);
+        for (uint8_t i = 0; bits; i++, bits >>= 1) {
+          if (bits & 1) {
+            uint8_t left = pgm_read_byte(&columnX[x + i]);
+            canvas_sprite_P(left, top, wall, SPRITE_WIDTH);
+            canvas_touch(left, left + CELL_SIZE - 1, top);
+          }
+        }
+      }
+    }
+    canvas_flush();
+  }
+}
 
-  char score_str[6];
-  itoa(*score, score_str, 10);
-  draw_label(nextx, 0, score_str);
+/**
+ * @brief Stages a tile for the next frame without touching the display.
+ * @param x Cell column (0 to GRID_WIDTH-1).
+ * @param y Cell row (0 to GRID_HEIGHT-1).
+ * @param tile Tile to stage (TILE_EMPTY, TILE_BODY, TILE_HEAD, TILE_FOOD).
+ */
+void stage_tile(uint8_t x, uint8_t y, uint8_t tile) {
+  uint16_t cell = y * GRID_WIDTH + x;
+  uint8_t shift = (cell % TILES_PER_BYTE) * TILE_BITS;
+  uint8_t* slot = &frame[cell / TILES_PER_BYTE];
+  uint8_t staged = (*slot & ~(TILE_MASK << shift)) | (tile << shift);
+  if (staged != *slot) {
+    *slot = staged;
+    dirtyRows |= (RowMask)1 << y;
+  }
 }
 
 /**
- * @brief Draws a circle using midpoint algorithm.
- * @param x0 Center x-coordinate (0-127).
- * @param y0 Center y-coordinate (0-63).
- * @param radius Circle radius in pixels.
+ * @brief Reads a staged or shown tile.
+ * @param grid frame or shadow.
+ * @param cell Cell index (y * GRID_WIDTH + x).
+ * @return TILE_* value.
  */
-void draw_circle(uint8_t x0, uint8_t y0, uint8_t radius) {
-  int16_t f = 1 - radius;
-  int16_t ddF_x = 1;
-  int16_t ddF_y = -2 * radius;
-  int16_t x = 0;
-  int16_t y = radius;
-
-  // Draw initial 4 cardinal points (optimized)
-  draw_pixel(x0, y0 + radius);
-  draw_pixel(x0, y0 - radius);
-  draw_pixel(x0 + radius, y0);
-  draw_pixel(x0 - radius, y0);
-
-  while (x < y) {
-    if (f >= 0) {
-      y--;
-      ddF_y += 2;
-      f += ddF_y;
+static uint8_t get_tile(const uint8_t* grid, uint16_t cell) {
+  uint8_t shift = (cell % TILES_PER_BYTE) * TILE_BITS;
+  return (grid[cell / TILES_PER_BYTE] >> shift) & TILE_MASK;
+}
+
+/**
+ * @brief Rasterises the changed columns of one display page.
+ * @param first First cell row of the page.
+ * @note A page column holds a cell of every row in the page, so each
+ * changed column is redrawn from all of them, walls included.
+ */
+static void flush_page(uint8_t first) {
+  ColumnMask changed = 0;
+  for (uint8_t y = first; y < first + ROWS_PER_PAGE; y++) {
+    for (uint8_t b = 0; b < ROW_BYTES; b++) {
+      uint8_t diff = frame[y * ROW_BYTES + b] ^ shadow[y * ROW_BYTES + b];
+      for (uint8_t i = 0; diff; i++, diff >>= TILE_BITS) {
+        if (diff & TILE_MASK) {
+          changed |= (ColumnMask)1 << (b * TILES_PER_BYTE + i);
+        }
+      }
     }
-    x++;
-    ddF_x += 2;
-    f += ddF_x;
-
-    // Draw all 8 symmetric points
-    draw_pixel(x0 + x, y0 + y);
-    draw_pixel(x0 + x, y0 - y);
-    draw_pixel(x0 - x, y0 + y);
-    draw_pixel(x0 - x, y0 - y);
-    draw_pixel(x0 + y, y0 + x);
-    draw_pixel(x0 + y, y0 - x);
-    draw_pixel(x0 - y, y0 + x);
-    draw_pixel(x0 - y, y0 - x);
   }
 
-  // Draw 45° points if missed (when x == y)
-  if (x == y) {
-    draw_pixel(x0 + x, y0 + y);
-    draw_pixel(x0 + x, y0 - y);
-    draw_pixel(x0 - x, y0 + y);
-    draw_pixel(x0 - x, y0 - y);
+  uint8_t top = pgm_read_byte(&rowY[first]);
+  for (uint8_t x = 0; changed; x++, changed >>= 1) {
+    if (!(changed & 1))
+      continue;
+    uint8_t left = pgm_read_byte(&columnX[x]);
+    for (uint8_t y = first; y < first + ROWS_PER_PAGE; y++) {
+      uint8_t tile = get_tile(frame, y * GRID_WIDTH + x);
+      if (tile != TILE_EMPTY) {
+        canvas_sprite_P(left, pgm_read_byte(&rowY[y]), sprites[tile],
+                        SPRITE_WIDTH);
+#if ROWS_PER_PAGE > 1
+      } else if (is_wall(y * GRID_WIDTH + x)) {
+        canvas_sprite_P(left, pgm_read_byte(&rowY[y]), wall, SPRITE_WIDTH);
+#endif
+      }
+    }
+    canvas_touch(left, left + CELL_SIZE - 1, top);
   }
+  memcpy(&shadow[first * ROW_BYTES], &frame[first * ROW_BYTES],
+         ROWS_PER_PAGE * ROW_BYTES);
 }
 
 /**
- * @brief Clears the game play area (below partition line).
+ * @brief Sends the cells whose tiles differ from the shadow grid.
+ * @note Only rows staged since the last flush are compared, four cells per
+ * byte. The pages from the first dirty one are composed on the canvas
+ * together and each sends one burst per run of changed cells, so the cost
+ * follows the number of changed cells, not the size of the grid.
  */
-void clear_play_area() {
-  for (uint8_t page = PARTITION_LINE_Y / 8 + 1; page < 128; page += 8) {
-    for (uint8_t x = 0; x < 128; x++) {
-      clear_page(x, page);
+void flush_frame() {
+  RowMask pending = dirtyRows;
+  dirtyRows = 0;
+  uint8_t y = 0;
+  while (pending) {
+    if (!(pending & 1)) {
+      pending >>= 1;
+      y++;
+      continue;
+    }
+
+    uint8_t first = y - y % ROWS_PER_PAGE;
+    canvas_begin(pgm_read_byte(&rowPage[first]));
+    for (uint8_t page = first; page < first + CANVAS_ROWS && page < GRID_HEIGHT;
+         page += ROWS_PER_PAGE) {
+      flush_page(page);
     }
+    canvas_flush();
+    pending >>= first + CANVAS_ROWS - y;
+    y = first + CANVAS_ROWS;
   }
 }
 
 /**
- * @brief Renders the snake on the display.
+ * @brief Stages the snakes for the next frame.
  * @param state Pointer to current GameState structure.
+ * @note After a clear every body is staged whole. From then on a move
+ * changes at most three cells per snake: the old tail empties, the old
+ * head becomes body and the new head appears, so only those are staged.
+ * A new head never lands on a cell another snake vacated the same tick,
+ * so the order of the snakes does not matter.
  */
 void draw_snake(GameState* state) {
-  for (uint8_t i = 0; i < state->snakeLength; i++) {
-    uint8_t x = state->snake[i].x * CELL_SIZE + 1;
-    uint8_t y = state->snake[i].y * CELL_SIZE + 1 + SCORE_AREA_HEIGHT;
-
-    for (uint8_t dy = 0; dy < CELL_SIZE - 2; dy++) {
-      for (uint8_t dx = 0; dx < CELL_SIZE - 2; dx++) {
-        draw_pixel(x + dx, y + dy);
+  PROBE_ENTER(PROBE_DRAW_SNAKE);
+  for (uint8_t i = 0; i < state->snakeCount; i++) {
+    const Snake* snake = &(state->snakes[i]);
+    Point head = snake_head(snake);
+    Point tail = snake_tail(snake);
+    if (!snakeDrawn) {
+      SnakeIter it;
+      snake_first(snake, &it);
+      while (it.remaining) {
+        stage_tile(it.pos.x, it.pos.y, TILE_BODY);
+        snake_next(snake, &it);
+      }
+    } else {
+      if (tail.x != drawnTail[i].x || tail.y != drawnTail[i].y) {
+        stage_tile(drawnTail[i].x, drawnTail[i].y, TILE_EMPTY);
+      }
+      if (head.x != drawnHead[i].x || head.y != drawnHead[i].y) {
+        stage_tile(drawnHead[i].x, drawnHead[i].y, TILE_BODY);
       }
     }
+    stage_tile(head.x, head.y, TILE_HEAD);
+    drawnHead[i] = head;
+    drawnTail[i] = tail;
   }
+  snakeDrawn = 1;
+  PROBE_LEAVE(PROBE_DRAW_SNAKE);
 }
 
 /**
- * @brief Renders the food item on the display.
+ * @brief Stages the food item for the next frame.
  * @param state Pointer to current GameState structure.
  */
 void draw_food(GameState* state) {
-  uint8_t foodX = state->food.x * CELL_SIZE + CELL_SIZE / 2;
-  uint8_t foodY = state->food.y * CELL_SIZE + CELL_SIZE / 2 + SCORE_AREA_HEIGHT;
-  draw_circle(foodX, foodY, CELL_SIZE / 2 - 1);
-}
\ No newline at end of file
+  PROBE_ENTER(PROBE_DRAW_FOOD);
+  stage_tile(state->food.x, state->food.y, TILE_FOOD);
+  PROBE_LEAVE(PROBE_DRAW_FOOD);
+}
@@ -9,28 +9,24 @@
 #include <stdint.h>
 #include "types.h"
 
-void draw_horizontal_line(uint8_t);
-
-void clear_page(uint8_t, uint8_t);
-
 uint8_t get_char_index(char);
 
 void draw_char(uint8_t, uint8_t, char);
 
-void draw_label(uint8_t, uint8_t, char*);
+void draw_score_label(uint8_t);
 
-void clear_score_area();
-
-void draw_score(uint16_t*);
+void draw_score(uint8_t, uint16_t*);
 
 void clear_play_area();
 
-void draw_snake(GameState*);
+void draw_walls(const uint8_t*);
 
-void draw_food(GameState*);
+void stage_tile(uint8_t, uint8_t, uint8_t);
+
+void flush_frame();
 
-void draw_pixel(uint8_t, uint8_t);
+void draw_snake(GameState*);
 
-void draw_circle(uint8_t, uint8_t, uint8_t);
+void draw_food(GameState*);
 
 #endif
@@ -0,0 +1,102 @@
+/**
+ * @file grid.c
+ * @brief Occupancy bitmap with one bit per grid cell.
+ */
+
+#include <avr/pgmspace.h>
+#include "config.h"
+#include "types.h"
+
+/**
+ * @brief Number of set bits in each nibble value.
+ */
+static const uint8_t nibble_bits[16] = {0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4};
+
+/**
+ * @brief Mask of each bit within a byte; AVR shifts one bit per cycle.
+ */
+static const uint8_t bit_masks[8] = {0x01, 0x02, 0x04, 0x08,
+                                     0x10, 0x20, 0x40, 0x80};
+
+/**
+ * @brief Replaces the grid with a bitmap from program memory.
+ * @param grid Pointer to the Grid to fill.
+ * @param cells GRID_BYTES bytes in program memory, in Grid order.
+ * @note Used to start a level: its walls become occupied cells, so they
+ * collide like a body and place_food never picks them.
+ */
+void grid_load_P(Grid* grid, const uint8_t* cells) {
+  memcpy_P(grid->cells, cells, GRID_BYTES);
+  grid->used = 0;
+  for (uint16_t i = 0; i < GRID_BYTES; i++) {
+    uint8_t bits = grid->cells[i];
+    grid->used += nibble_bits[bits & 0x0F] + nibble_bits[bits >> 4];
+  }
+}
+
+/**
+ * @brief Marks a cell as occupied.
+ * @param grid Pointer to the Grid to update.
+ * @param p Cell to mark (must currently be free).
+ */
+void grid_mark(Grid* grid, Point p) {
+  uint16_t cell = p.y * GRID_WIDTH + p.x;
+  grid->cells[cell >> 3] |= bit_masks[cell & 7];
+  grid->used++;
+}
+
+/**
+ * @brief Marks a cell as free.
+ * @param grid Pointer to the Grid to update.
+ * @param p Cell to unmark (must currently be occupied).
+ */
+void grid_unmark(Grid* grid, Point p) {
+  uint16_t cell = p.y * GRID_WIDTH + p.x;
+  grid->cells[cell >> 3] &= ~bit_masks[cell & 7];
+  grid->used--;
+}
+
+/**
+ * @brief Tests whether a cell is occupied.
+ * @param grid Pointer to the Grid to query.
+ * @param p Cell to test.
+ * @return Non-zero if occupied, 0 if free.
+ */
+uint8_t grid_test(const Grid* grid, Point p) {
+  uint16_t cell = p.y * GRID_WIDTH + p.x;
+  return grid->cells[cell >> 3] & bit_masks[cell & 7];
+}
+
+/**
+ * @brief Finds the n-th free cell in row-major order.
+ * @param grid Pointer to the Grid to query.
+ * @param n Zero-based index among free cells (must be below free count).
+ * @return Position of the selected free cell.
+ * @note Skips whole bytes by bit count, so cost is bounded by GRID_BYTES.
+ */
+Point grid_free_cell(const Grid* grid, uint16_t n) {
+  uint16_t i = 0;
+  for (; i < GRID_BYTES - 1; i++) {
+    uint8_t bits = grid->cells[i];
+    uint8_t free = 8 - nibble_bits[bits & 0x0F] - nibble_bits[bits >> 4];
+    if (n < free) {
+      break;
+    }
+    n -= free;
+  }
+
+  uint8_t bit = 0;
+  for (; bit < 7; bit++) {
+    if (!(grid->cells[i] & bit_masks[bit])) {
+      if (n == 0) {
+        break;
+      }
+      n--;
+    }
+  }
+
+  uint16_t cell = i * 8 + bit;
+  Point p = {cell % GRID_WIDTH, cell / GRID_WIDTH};
+  return p;
+}
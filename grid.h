@@ -0,0 +1,22 @@
+/**
+ * @file grid.h
+ * @brief Header file for the cell occupancy bitmap of the Snake game.
+ */
+
+#ifndef SNAKE_GAME_GRID_H
+#define SNAKE_GAME_GRID_H
+
+#include <stdint.h>
+#include "types.h"
+
+void grid_load_P(Grid*, const uint8_t*);
+
+void grid_mark(Grid*, Point);
+
+void grid_unmark(Grid*, Point);
+
+uint8_t grid_test(const Grid*, Point);
+
+Point grid_free_cell(const Grid*, uint16_t);
+
+#endif
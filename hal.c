@@ -0,0 +1,139 @@
+/**
+ * @file hal.c
+ * @brief Hardware abstraction layer for the ATmega328P board.
+ */
+
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/delay.h>
+#include "config.h"
+#include "input.h"
+
+static const uint8_t* volatile postData;  // Next byte of the posted block
+static volatile uint16_t postAddr;        // EEPROM address it goes to
+static volatile uint16_t postLeft = 0;    // Bytes still to write
+
+/**
+ * @brief Drives the display reset line.
+ * @param active Non-zero to hold the display in reset (RES low).
+ */
+void hal_display_reset(uint8_t active) {
+  if (active) {
+    PORTB &= ~(1 << RES_PIN);
+  } else {
+    PORTB |= (1 << RES_PIN);
+  }
+}
+
+/**
+ * @brief Busy-waits for a number of milliseconds.
+ * @param ms Milliseconds to wait.
+ */
+void hal_delay_ms(uint16_t ms) {
+  while (ms--) {
+    _delay_ms(1);
+  }
+}
+
+/**
+ * @brief Reads the direction buttons.
+ * @return Mask of pressed buttons (BUTTON_* bits, active high).
+ */
+uint8_t hal_buttons() {
+  return ~PIND & BUTTON_MASK;
+}
+
+/**
+ * @brief Reads the second player's direction buttons.
+ * @return Mask of pressed buttons (BUTTON_* bits, active high).
+ * @note The PORTC pins are moved onto the PORTD bit positions, so the
+ * result is interpreted exactly like hal_buttons().
+ */
+uint8_t hal_buttons2() {
+  uint8_t pins = ~PINC;
+  return ((pins >> P2_UP_BTN_PIN) & 1) << UP_BTN_PIN |
+         ((pins >> P2_DOWN_BTN_PIN) & 1) << DOWN_BTN_PIN |
+         ((pins >> P2_LEFT_BTN_PIN) & 1) << LEFT_BTN_PIN |
+         ((pins >> P2_RIGHT_BTN_PIN) & 1) << RIGHT_BTN_PIN;
+}
+
+/**
+ * @brief Gathers a seed from ADC noise and Timer1 jitter.
+ * @return 16 bits of boot-time entropy.
+ * @note Samples a floating pin; only the noisy LSB of each conversion is
+ * kept. The ADC is switched off again afterwards.
+ */
+uint16_t hal_entropy() {
+  uint16_t seed = TCNT1;
+  ADMUX = (1 << REFS0) | RANDOM_ADC_CHANNEL;  // AVcc reference
+  ADCSRA = (1 << ADEN) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+  for (uint8_t i = 0; i < RANDOM_ADC_SAMPLES; i++) {
+    ADCSRA |= (1 << ADSC);
+    while (ADCSRA & (1 << ADSC))
+      ;
+    seed = (seed << 1 | seed >> 15) ^ (ADC & 1) ^ TCNT1;
+  }
+  ADCSRA = 0;
+  return seed;
+}
+
+/**
+ * @brief Reads a block from the on-chip EEPROM.
+ * @param addr EEPROM byte address.
+ * @param data Destination buffer.
+ * @param len Number of bytes.
+ */
+void hal_storage_read(uint16_t addr, void* data, uint16_t len) {
+  while (postLeft)
+    ;  // The EEPROM ready handler owns the address register
+  eeprom_read_block(data, (const void*)addr, len);
+}
+
+/**
+ * @brief Starts writing a block to the EEPROM in the background.
+ * @param addr EEPROM byte address.
+ * @param data Source buffer; must stay unchanged until the write is done.
+ * @param len Number of bytes.
+ * @return 1 if started, 0 if a previous block is still being written.
+ * @note The EEPROM ready interrupt writes one byte per 3.4 ms, skipping
+ * unchanged bytes, so the caller never waits on the EEPROM.
+ */
+uint8_t hal_storage_post(uint16_t addr, const void* data, uint16_t len) {
+  if (postLeft)
+    return 0;
+  postData = data;
+  postAddr = addr;
+  postLeft = len;
+  EECR |= (1 << EERIE);
+  return 1;
+}
+
+/**
+ * @brief Tells whether a posted block is still being written.
+ * @return Non-zero until the last byte of the block is in the EEPROM.
+ */
+uint8_t hal_storage_busy() {
+  return postLeft || (EECR & (1 << EEPE));
+}
+
+/**
+ * @brief EEPROM ready handler, starts the next changed byte of the block.
+ * @note Runs with interrupts off, so EEMPE and EEPE are set within the
+ * four cycles the hardware allows.
+ */
+ISR(EE_READY_vect) {
+  while (postLeft) {
+    uint8_t value = *postData++;
+    EEAR = postAddr++;
+    postLeft--;
+    EECR |= (1 << EERE);
+    if (EEDR != value) {
+      EEDR = value;
+      EECR |= (1 << EEMPE);
+      EECR |= (1 << EEPE);
+      return;
+    }
+  }
+  EECR &= ~(1 << EERIE);
+}
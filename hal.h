@@ -0,0 +1,28 @@
+/**
+ * @file hal.h
+ * @brief Header file for the board hardware abstraction layer.
+ * @note Implemented by hal.c on the ATmega328P and host/hal.c on Linux.
+ */
+
+#ifndef SNAKE_GAME_HAL_H
+#define SNAKE_GAME_HAL_H
+
+#include <stdint.h>
+
+void hal_display_reset(uint8_t);
+
+void hal_delay_ms(uint16_t);
+
+uint8_t hal_buttons();
+
+uint8_t hal_buttons2();
+
+uint16_t hal_entropy();
+
+void hal_storage_read(uint16_t, void*, uint16_t);
+
+uint8_t hal_storage_post(uint16_t, const void*, uint16_t);
+
+uint8_t hal_storage_busy();
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file emulator.c
+ * @brief Decodes the SH1107 command/data stream into a 128x128 framebuffer.
+ * @note Models page addressing only: page (0xB0-0xBF), column nibbles
+ * (0x00-0x0F, 0x10-0x17) and data writes with column auto-increment. RAM is
+ * kept as addressed; segment remap and COM scan direction are not applied.
+ * Two-byte commands consume their argument, including the SSD1306-style
+ * 0x8D and 0xDA that sh1107_init sends. Other commands are ignored.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "emulator.h"
+
+static uint8_t ram[EMU_PAGES][EMU_WIDTH];  // Display RAM, bit n = row n
+static uint8_t page = 0;                   // Current page address
+static uint8_t column = 0;                 // Current column address
+static uint8_t pendingArgs = 0;            // Argument bytes still expected
+
+/**
+ * @brief Clears display RAM and the address pointers.
+ */
+void emu_reset() {
+  memset(ram, 0, sizeof(ram));
+  page = 0;
+  column = 0;
+  pendingArgs = 0;
+}
+
+/**
+ * @brief Applies one byte of the SPI stream.
+ * @param byte Byte clocked out on MOSI.
+ * @param isData Level of DC while the byte was sent (1 = data).
+ */
+void emu_write(uint8_t byte, uint8_t isData) {
+  if (isData) {
+    ram[page][column] = byte;
+    column = (column + 1) % EMU_WIDTH;
+    return;
+  }
+
+  if (pendingArgs) {
+    pendingArgs--;
+  } else if (byte <= 0x0F) {
+    column = (column & 0x70) | byte;
+  } else if (byte <= 0x17) {
+    column = (column & 0x0F) | ((byte & 0x07) << 4);
+  } else if (byte >= 0xB0 && byte <= 0xBF) {
+    page = byte & 0x0F;
+  } else {
+    switch (byte) {
+      case 0x81:  // Contrast
+      case 0x8D:  // Charge pump (SSD1306)
+      case 0xA8:  // Multiplex ratio
+      case 0xAD:  // DC-DC control
+      case 0xD3:  // Display offset
+      case 0xD5:  // Clock divider
+      case 0xD9:  // Pre-charge period
+      case 0xDA:  // COM pins (SSD1306)
+      case 0xDB:  // VCOMH deselect level
+      case 0xDC:  // Display start line
+        pendingArgs = 1;
+        break;
+    }
+  }
+}
+
+/**
+ * @brief Reads one pixel of display RAM.
+ * @param x Column (0-127).
+ * @param y Row (0-127).
+ * @return 1 if the pixel is lit, 0 otherwise.
+ */
+uint8_t emu_pixel(uint8_t x, uint8_t y) {
+  return (ram[y / 8][x] >> (y % 8)) & 1;
+}
+
+/**
+ * @brief Hashes display RAM (32-bit FNV-1a) for frame comparisons.
+ * @return Hash of the current frame.
+ */
+uint32_t emu_hash() {
+  uint32_t hash = 2166136261u;
+  for (uint16_t p = 0; p < EMU_PAGES; p++) {
+    for (uint16_t x = 0; x < EMU_WIDTH; x++) {
+      hash = (hash ^ ram[p][x]) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+/**
+ * @brief Writes display RAM as a binary PGM image.
+ * @param path Output file path.
+ * @return 0 on success, -1 on I/O error.
+ */
+int emu_dump_pgm(const char* path) {
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    return -1;
+  }
+  fprintf(file, "P5\n%d %d\n255\n", EMU_WIDTH, EMU_HEIGHT);
+  for (uint16_t y = 0; y < EMU_HEIGHT; y++) {
+    for (uint16_t x = 0; x < EMU_WIDTH; x++) {
+      fputc(emu_pixel(x, y) ? 255 : 0, file);
+    }
+  }
+  return fclose(file) ? -1 : 0;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file emulator.h
+ * @brief Header file for the host-side SH1107 command stream emulator.
+ */
+
+#ifndef SNAKE_GAME_HOST_EMULATOR_H
+#define SNAKE_GAME_HOST_EMULATOR_H
+
+#include <stdint.h>
+
+#define EMU_WIDTH 128
+#define EMU_HEIGHT 128
+#define EMU_PAGES (EMU_HEIGHT / 8)
+
+void emu_reset();
+
+void emu_write(uint8_t, uint8_t);
+
+uint8_t emu_pixel(uint8_t, uint8_t);
+
+uint32_t emu_hash();
+
+int emu_dump_pgm(const char*);
+
+#endif
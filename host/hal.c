@@ -0,0 +1,125 @@
+/**
+ * @file hal.c
+ * @brief Hardware abstraction layer for the Linux host build.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "emulator.h"
+#include "host.h"
+#include "timer.h"
+
+#define EEPROM_SIZE 1024  // ATmega328P EEPROM bytes
+
+static uint8_t buttons = 0;            // Pressed buttons (BUTTON_* bits)
+static uint8_t eeprom[EEPROM_SIZE];    // EEPROM image
+static const char* eepromPath = NULL;  // File backing the image, if any
+
+/**
+ * @brief Drives the display reset line; asserting it clears display RAM.
+ * @param active Non-zero to hold the display in reset.
+ */
+void hal_display_reset(uint8_t active) {
+  if (active) {
+    emu_reset();
+  }
+}
+
+/**
+ * @brief Advances the virtual clock instead of waiting.
+ * @param ms Milliseconds to wait.
+ */
+void hal_delay_ms(uint16_t ms) {
+  timer_advance(ms);
+}
+
+/**
+ * @brief Reads the direction buttons.
+ * @return Mask of pressed buttons (BUTTON_* bits, active high).
+ */
+uint8_t hal_buttons() {
+  return buttons;
+}
+
+/**
+ * @brief Reads the second player's direction buttons.
+ * @return Always 0: the host drives the second snake with the autopilot.
+ */
+uint8_t hal_buttons2() {
+  return 0;
+}
+
+/**
+ * @brief Gathers a seed from the wall clock and process id.
+ * @return 16 bits of entropy.
+ */
+uint16_t hal_entropy() {
+  return (uint16_t)(time(NULL) ^ getpid());
+}
+
+/**
+ * @brief Sets the buttons reported by hal_buttons().
+ * @param pressed Mask of pressed buttons (BUTTON_* bits).
+ */
+void host_set_buttons(uint8_t pressed) {
+  buttons = pressed;
+}
+
+/**
+ * @brief Reads a block from the EEPROM image.
+ * @param addr EEPROM byte address.
+ * @param data Destination buffer.
+ * @param len Number of bytes; reads past the end return erased bytes.
+ */
+void hal_storage_read(uint16_t addr, void* data, uint16_t len) {
+  uint8_t* dst = data;
+  for (uint16_t i = 0; i < len; i++) {
+    dst[i] = addr + i < EEPROM_SIZE ? eeprom[addr + i] : 0xFF;
+  }
+}
+
+/**
+ * @brief Writes a block to the EEPROM image and its backing file at once.
+ * @param addr EEPROM byte address.
+ * @param data Source buffer.
+ * @param len Number of bytes; writes past the end are dropped.
+ * @return 1; the host never has a write in flight.
+ */
+uint8_t hal_storage_post(uint16_t addr, const void* data, uint16_t len) {
+  const uint8_t* src = data;
+  for (uint16_t i = 0; i < len && addr + i < EEPROM_SIZE; i++) {
+    eeprom[addr + i] = src[i];
+  }
+  if (eepromPath) {
+    FILE* file = fopen(eepromPath, "wb");
+    if (file) {
+      fwrite(eeprom, 1, EEPROM_SIZE, file);
+      fclose(file);
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief Tells whether a posted block is still being written.
+ * @return 0.
+ */
+uint8_t hal_storage_busy() {
+  return 0;
+}
+
+/**
+ * @brief Backs the EEPROM image with a file, loading it if it exists.
+ * @param path Image file; a missing or short file reads as erased.
+ */
+void host_set_storage(const char* path) {
+  memset(eeprom, 0xFF, EEPROM_SIZE);
+  eepromPath = path;
+  FILE* file = fopen(path, "rb");
+  if (file) {
+    fread(eeprom, 1, EEPROM_SIZE, file);
+    fclose(file);
+  }
+}
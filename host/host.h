@@ -0,0 +1,25 @@
+/**
+ * @file host.h
+ * @brief Header file for host-only hooks into the HAL, bus and clock.
+ */
+
+#ifndef SNAKE_GAME_HOST_HOST_H
+#define SNAKE_GAME_HOST_HOST_H
+
+#include <stdint.h>
+
+typedef struct {
+  uint32_t bytes;         // Bytes clocked out
+  uint32_t commands;      // Bytes sent with DC low
+  uint32_t transactions;  // CS-low frames
+} BusStats;
+
+extern BusStats busStats;
+
+void host_set_buttons(uint8_t);
+
+void host_set_storage(const char*);
+
+void timer_advance(uint32_t);
+
+#endif
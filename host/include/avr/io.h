@@ -0,0 +1,37 @@
+/**
+ * @file io.h
+ * @brief Host stand-in for <avr/io.h>: port bit numbers only.
+ * @note Lets config.h pin definitions compile on Linux; no registers exist.
+ */
+
+#ifndef SNAKE_GAME_HOST_AVR_IO_H
+#define SNAKE_GAME_HOST_AVR_IO_H
+
+#include <stdint.h>
+
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ * @file pgmspace.h
+ * @brief Host stand-in for <avr/pgmspace.h>: flash data is ordinary memory.
+ */
+
+#ifndef SNAKE_GAME_HOST_AVR_PGMSPACE_H
+#define SNAKE_GAME_HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define memcpy_P(dst, src, n) memcpy((dst), (src), (n))
+
+#endif
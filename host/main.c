@@ -0,0 +1,265 @@
+/**
+ * @file main.c
+ * @brief Host entry point: runs the game against the SH1107 emulator.
+ * @note Prints one CSV row per frame with the SPI bytes and transactions it
+ * cost, so rendering paths can be compared by exact bus traffic.
+ *
+ * Usage: snake_host [-n ticks] [-s seed] [-i script] [-o dir] [-c | -a]
+ *                   [-2] [-l level] [-w file | -r file]
+ * - -n  Number of game ticks to run (default 1000).
+ * - -s  Seed for the food placement random stream (default 1).
+ * - -i  Input script, one "<tick> <U|D|L|R>" press per line.
+ * - -o  Directory to write frame_NNNNN.pgm images into.
+ * - -c  Chase the food with a greedy driver instead of a script.
+ * - -a  Let the autopilot play instead of a script; fills the board.
+ * - -2  Add a second snake on the same grid, steered by the autopilot
+ *       (16x14 board only).
+ *       The length and score columns stay those of the first snake; games
+ *       with two snakes are neither saved nor scored.
+ * - -l  Level to play (default 0, the open board); replays use their own.
+ * - -w  Record the game into an EEPROM image file, saved at every game
+ *       over and at the end of the run. Scores go into the image's
+ *       high-score table, printed when the run ends.
+ * - -r  Replay the game recorded in an EEPROM image file, ignoring -i and
+ *       -c; stops at its game over. Frames match the recording exactly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "autopilot.h"
+#include "config.h"
+#include "display.h"
+#include "emulator.h"
+#include "game.h"
+#include "host.h"
+#include "input.h"
+#include "random.h"
+#include "replay.h"
+#include "serial.h"
+#include "snake.h"
+#include "store.h"
+#include "timer.h"
+#include "types.h"
+
+/**
+ * @brief Maps a script letter to a button mask.
+ * @param c One of U, D, L, R.
+ * @return BUTTON_* bit, or 0 for anything else.
+ */
+static uint8_t button_for(char c) {
+  switch (c) {
+    case 'U':
+      return BUTTON_UP;
+    case 'D':
+      return BUTTON_DOWN;
+    case 'L':
+      return BUTTON_LEFT;
+    case 'R':
+      return BUTTON_RIGHT;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Picks the button that steers the head toward the food.
+ * @param state Pointer to the current GameState structure.
+ * @return BUTTON_* bit.
+ */
+static uint8_t chase_button(GameState* state) {
+  Point head = snake_head(&(state->snakes[0]));
+  if (head.x < state->food.x) {
+    return BUTTON_RIGHT;
+  } else if (head.x > state->food.x) {
+    return BUTTON_LEFT;
+  } else if (head.y < state->food.y) {
+    return BUTTON_DOWN;
+  }
+  return BUTTON_UP;
+}
+
+/**
+ * @brief Presses and releases a button through the input handler.
+ * @param buttons BUTTON_* mask to press.
+ */
+static void press(uint8_t buttons) {
+  host_set_buttons(buttons);
+  input_update(0, buttons, timer_millis());
+  host_set_buttons(0);
+}
+
+/**
+ * @brief Resets the game, logging or replaying its input.
+ * @param state Pointer to the current GameState structure.
+ * @param replay Pointer to the recording.
+ * @param mode REPLAY_RECORD or REPLAY_PLAY.
+ */
+static void start_game(GameState* state, Replay* replay, uint8_t mode) {
+  input_clear();
+  replay_begin(replay, state, mode);
+  reset_game(state);
+}
+
+int main(int argc, char** argv) {
+  uint32_t ticks = 1000;
+  unsigned seed = 1;
+  const char* outDir = NULL;
+  FILE* script = NULL;
+  uint8_t chase = 0;
+  uint8_t autopilot = 0;
+  uint8_t snakes = 1;
+  uint8_t level = 0;
+  const char* storage = NULL;
+  uint8_t mode = REPLAY_RECORD;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:i:o:ca2l:w:r:")) != -1) {
+    switch (opt) {
+      case 'n':
+        ticks = strtoul(optarg, NULL, 10);
+        break;
+      case 's':
+        seed = strtoul(optarg, NULL, 10);
+        break;
+      case 'i':
+        script = fopen(optarg, "r");
+        if (!script) {
+          perror(optarg);
+          return 1;
+        }
+        break;
+      case 'o':
+        outDir = optarg;
+        break;
+      case 'c':
+        chase = 1;
+        break;
+      case 'a':
+        autopilot = 1;
+        break;
+      case '2':
+        snakes = MAX_SNAKES;
+        break;
+      case 'l':
+        level = strtoul(optarg, NULL, 10);
+        break;
+      case 'w':
+      case 'r':
+        storage = optarg;
+        mode = opt == 'r' ? REPLAY_PLAY : REPLAY_RECORD;
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-n ticks] [-s seed] [-i script] [-o dir] [-c | -a] "
+                "[-2] [-l level] [-w file | -r file]\n",
+                argv[0]);
+        return 2;
+    }
+  }
+
+  static GameState game;
+  static Replay replay;
+  GameState* state = &game;
+  random_seed(&(state->rng), seed);
+  if (storage) {
+    host_set_storage(storage);
+  }
+  store_init();
+  if (mode == REPLAY_PLAY && !replay_load(&replay)) {
+    fprintf(stderr, "%s: no recording\n", storage);
+    return 1;
+  }
+
+  timer_init();
+  spi_init();
+  sh1107_init();
+  if (snakes > 1 && mode == REPLAY_PLAY) {
+    fprintf(stderr, "%s: recordings are single-snake, ignoring -2\n",
+            storage);
+    snakes = 1;
+  }
+  state->snakeCount = snakes;
+  state->level = level;
+#if MAX_SNAKES > 1
+  static uint8_t direction2;  // Second snake's latched direction
+  state->snakes[1].direction = &direction2;
+#endif
+  start_game(state, &replay, mode);
+
+  long nextTick = -1;
+  char nextKey = 0;
+  if (script && fscanf(script, "%ld %c", &nextTick, &nextKey) != 2) {
+    nextTick = -1;
+  }
+
+  printf("frame,bytes,commands,transactions,length,score,hash\n");
+  for (uint32_t tick = 0; tick < ticks; tick++) {
+    while (nextTick >= 0 && (uint32_t)nextTick <= tick) {
+      press(button_for(nextKey));
+      if (fscanf(script, "%ld %c", &nextTick, &nextKey) != 2) {
+        nextTick = -1;
+      }
+    }
+    if (chase) {
+      press(chase_button(state));
+    }
+    timer_advance(MOVE_DELAY);
+
+    BusStats before = busStats;
+    if (state->gameOver) {
+      if (mode == REPLAY_PLAY) {
+        break;
+      }
+      start_game(state, &replay, REPLAY_RECORD);
+    } else {
+      replay_tick(&replay, autopilot
+                               ? autopilot_direction(state, &(state->snakes[0]))
+                               : input_next(0, replay.direction));
+#if MAX_SNAKES > 1
+      if (state->snakeCount > 1) {
+        *(state->snakes[1].direction) =
+            autopilot_direction(state, &(state->snakes[1]));
+      }
+#endif
+      move_snake(state);
+      render_game(state);
+      if (state->gameOver && storage && mode == REPLAY_RECORD &&
+          state->snakeCount == 1) {
+        replay_save(&replay);
+        store_submit_score(state->snakes[0].score);
+        store_poll();
+      }
+    }
+
+    printf("%u,%u,%u,%u,%u,%u,%08x\n", tick,
+           busStats.bytes - before.bytes,
+           busStats.commands - before.commands,
+           busStats.transactions - before.transactions,
+           state->snakes[0].length, state->snakes[0].score, emu_hash());
+
+    if (outDir) {
+      char path[512];
+      snprintf(path, sizeof(path), "%s/frame_%05u.pgm", outDir, tick);
+      if (emu_dump_pgm(path)) {
+        perror(path);
+        return 1;
+      }
+    }
+  }
+
+  if (storage && mode == REPLAY_RECORD && !state->gameOver &&
+      state->snakeCount == 1 && !replay_save(&replay)) {
+    fprintf(stderr, "%s: recording overflowed, not saved\n", storage);
+  }
+  fprintf(stderr, "total bytes %u, transactions %u\n", busStats.bytes,
+          busStats.transactions);
+  if (storage) {
+    fprintf(stderr, "high scores");
+    for (uint8_t rank = 0; rank < HIGH_SCORE_COUNT; rank++) {
+      fprintf(stderr, " %u", store_high_score(rank));
+    }
+    fprintf(stderr, "\n");
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file serial.c
+ * @brief Host display bus: feeds the SH1107 emulator and counts traffic.
+ * @note Bytes outside spi_begin()/spi_end() count as one transaction each,
+ * which is how they would be framed if the AVR queue had drained between
+ * them.
+ */
+
+#include "emulator.h"
+#include "host.h"
+#include "serial.h"
+
+BusStats busStats;
+static uint8_t held = 0;  // CS held by caller
+
+/**
+ * @brief Resets the emulated display and the traffic counters.
+ */
+void spi_init() {
+  emu_reset();
+  busStats.bytes = 0;
+  busStats.commands = 0;
+  busStats.transactions = 0;
+}
+
+/**
+ * @brief Delivers a byte to the emulator.
+ * @param data The byte to transmit.
+ * @param mode SPI_MODE_COMMAND or SPI_MODE_DATA.
+ */
+static void spi_queue(uint8_t data, uint8_t mode) {
+  if (!held) {
+    busStats.transactions++;
+  }
+  busStats.bytes++;
+  if (mode == SPI_MODE_COMMAND) {
+    busStats.commands++;
+  }
+  emu_write(data, mode);
+}
+
+/**
+ * @brief Sends a data byte (DC high).
+ * @param data The byte to transmit.
+ */
+void spi_write(uint8_t data) {
+  spi_queue(data, SPI_MODE_DATA);
+}
+
+/**
+ * @brief Sends a command byte (DC low).
+ * @param cmd The byte to transmit.
+ */
+void spi_command(uint8_t cmd) {
+  spi_queue(cmd, SPI_MODE_COMMAND);
+}
+
+/**
+ * @brief Opens a transaction.
+ */
+void spi_begin() {
+  held = 1;
+  busStats.transactions++;
+}
+
+/**
+ * @brief Closes a transaction.
+ */
+void spi_end() {
+  held = 0;
+}
+
+/**
+ * @brief Nothing to wait for; host writes complete immediately.
+ */
+void spi_flush() {}
+
+/**
+ * @brief Tells whether bytes are still in flight (never on host).
+ * @return 0.
+ */
+uint8_t spi_busy() {
+  return 0;
+}
+
+/**
+ * @brief Returns the deepest queue occupancy seen (always 0 on host).
+ * @return 0.
+ */
+uint8_t spi_high_water() {
+  return 0;
+}
+
+/**
+ * @brief Returns the number of bytes sent since spi_init().
+ * @return Byte count.
+ */
+uint32_t spi_bytes_sent() {
+  return busStats.bytes;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file timer.c
+ * @brief Virtual millisecond clock for the host build.
+ */
+
+#include "host.h"
+#include "timer.h"
+
+static uint32_t milliseconds = 0;
+
+/**
+ * @brief Resets the virtual clock.
+ */
+void timer_init() {
+  milliseconds = 0;
+}
+
+/**
+ * @brief Returns virtual milliseconds elapsed since timer_init().
+ * @return Millisecond timestamp.
+ */
+uint32_t timer_millis() {
+  return milliseconds;
+}
+
+/**
+ * @brief Moves the virtual clock forward.
+ * @param ms Milliseconds to advance.
+ */
+void timer_advance(uint32_t ms) {
+  milliseconds += ms;
+}
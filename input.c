@@ -0,0 +1,101 @@
+/**
+ * @file input.c
+ * @brief Button debouncing and the turn queue for the Snake game.
+ * @note Each player has a queue. A queue is single-producer/single-consumer:
+ * only that player's button ISR advances head and only the game tick
+ * advances tail. Each index is one byte, so reads and writes are atomic
+ * and no locking is needed.
+ */
+
+#include "config.h"
+#include "input.h"
+
+#define QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+
+#if INPUT_QUEUE_SIZE & QUEUE_MASK
+#error "INPUT_QUEUE_SIZE must be a power of two"
+#endif
+
+typedef struct {
+  volatile uint8_t turns[INPUT_QUEUE_SIZE];  // Requested turns
+  volatile uint8_t head;                     // Next slot to write
+  volatile uint8_t tail;                     // Next turn to apply
+  uint32_t lastInterrupt;                    // Time of the last accepted edge
+} TurnQueue;
+
+static TurnQueue queues[MAX_SNAKES];  // One per player
+
+/**
+ * @brief Applies a button state change to a player's turn queue.
+ * @param player Player the buttons belong to, below MAX_SNAKES.
+ * @param buttons Mask of pressed buttons (BUTTON_* bits).
+ * @param now Current time in milliseconds.
+ * @note Implements:
+ * - Debouncing (DEBOUNCE_TIME)
+ * - Queueing of the requested direction; repeats of the newest queued
+ *   turn and presses into a full queue are dropped
+ */
+void input_update(uint8_t player, uint8_t buttons, uint32_t now) {
+  TurnQueue* queue = &queues[player];
+
+  if (now - queue->lastInterrupt < DEBOUNCE_TIME)
+    return;
+  queue->lastInterrupt = now;
+
+  uint8_t turn;
+  if (buttons & BUTTON_UP) {
+    turn = DIRECTION_UP;
+  } else if (buttons & BUTTON_DOWN) {
+    turn = DIRECTION_DOWN;
+  } else if (buttons & BUTTON_LEFT) {
+    turn = DIRECTION_LEFT;
+  } else if (buttons & BUTTON_RIGHT) {
+    turn = DIRECTION_RIGHT;
+  } else {
+    return;
+  }
+
+  uint8_t head = queue->head;
+  uint8_t used = head - queue->tail;
+  if (used >= INPUT_QUEUE_SIZE)
+    return;
+  if (used && queue->turns[(head - 1) & QUEUE_MASK] == turn)
+    return;
+  queue->turns[head & QUEUE_MASK] = turn;
+  queue->head = head + 1;
+}
+
+/**
+ * @brief Pops a player's turn to apply on this tick.
+ * @param player Player whose queue is read, below MAX_SNAKES.
+ * @param heading Direction the snake moved on the previous tick.
+ * @return First queued turn that is neither the heading nor its reverse,
+ * or heading when there is none.
+ * @note Turns made invalid by an earlier one (e.g. LEFT queued while
+ * already heading left) are discarded without costing a tick.
+ */
+uint8_t input_next(uint8_t player, uint8_t heading) {
+  TurnQueue* queue = &queues[player];
+  uint8_t tail = queue->tail;
+  while (tail != queue->head) {
+    uint8_t turn = queue->turns[tail & QUEUE_MASK];
+    tail++;
+    // Opposite directions differ only in bit 1 (UP 3/DOWN 1, LEFT 2/RIGHT 0)
+    if (turn != heading && turn != (heading ^ 2)) {
+      heading = turn;
+      break;
+    }
+  }
+  queue->tail = tail;
+  return heading;
+}
+
+/**
+ * @brief Discards all queued turns of every player.
+ * @note Called from the game loop on reset; the ISRs may still push.
+ */
+void input_clear() {
+  for (uint8_t i = 0; i < MAX_SNAKES; i++) {
+    queues[i].tail = queues[i].head;
+  }
+}
@@ -0,0 +1,25 @@
+/**
+ * @file input.h
+ * @brief Header file for button input handling in the Snake game.
+ */
+
+#ifndef SNAKE_GAME_INPUT_H
+#define SNAKE_GAME_INPUT_H
+
+#include <stdint.h>
+#include "config.h"
+
+#define BUTTON_UP (1 << UP_BTN_PIN)
+#define BUTTON_DOWN (1 << DOWN_BTN_PIN)
+#define BUTTON_LEFT (1 << LEFT_BTN_PIN)
+#define BUTTON_RIGHT (1 << RIGHT_BTN_PIN)
+#define BUTTON_MASK (BUTTON_UP | BUTTON_DOWN | BUTTON_LEFT | BUTTON_RIGHT)
+#define PAUSE_BUTTONS (BUTTON_LEFT | BUTTON_RIGHT)  // Held together to pause
+
+void input_update(uint8_t, uint8_t, uint32_t);
+
+uint8_t input_next(uint8_t, uint8_t);
+
+void input_clear();
+
+#endif
@@ -0,0 +1,32 @@
+/**
+ * @file level.c
+ * @brief Wall maps of the Snake game's levels, kept in flash.
+ * @note Maps are bit-packed in Grid order (see tools/gen_levels.py), so
+ * grid_load_P() starts a level with one copy and the renderer looks up a
+ * wall with one byte read. A map costs GRID_BYTES of flash and no SRAM.
+ */
+
+#include <avr/pgmspace.h>
+#include "config.h"
+#include "level.h"
+
+static const uint8_t levels[LEVEL_COUNT][GRID_BYTES] PROGMEM = LEVELS;
+
+/**
+ * @brief Returns the wall map of a level.
+ * @param level Level number; out of range numbers (e.g. from a store
+ * written with another GEOMETRY) select level 0.
+ * @return GRID_BYTES bytes in program memory, a set bit per wall cell.
+ */
+const uint8_t* level_walls(uint8_t level) {
+  return levels[level < LEVEL_COUNT ? level : 0];
+}
+
+/**
+ * @brief Tells whether a level is the open wrap-around board.
+ * @param level Level number, mapped like level_walls().
+ * @return Non-zero if the level has no walls.
+ */
+uint8_t level_is_open(uint8_t level) {
+  return level == 0 || level >= LEVEL_COUNT;
+}
@@ -0,0 +1,16 @@
+/**
+ * @file level.h
+ * @brief Header file for the wall maps of the Snake game's levels.
+ */
+
+#ifndef SNAKE_GAME_LEVEL_H
+#define SNAKE_GAME_LEVEL_H
+
+#include <stdint.h>
+#include "levels.h"
+
+const uint8_t* level_walls(uint8_t);
+
+uint8_t level_is_open(uint8_t);
+
+#endif
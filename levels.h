@@ -0,0 +1,75 @@
+/**
+ * @file levels.h
+ * @brief Wall maps for every GEOMETRY_* preset in config.h.
+ * @note Generated by tools/gen_levels.py (make levels); do not edit.
+ * LEVEL_n holds GRID_BYTES bytes, one bit per cell in Grid order; a set
+ * bit is a wall. Level 0 is the open wrap-around board.
+ */
+
+#ifndef SNAKE_GAME_LEVELS_H
+#define SNAKE_GAME_LEVELS_H
+
+#include "config.h"
+
+#define LEVEL_COUNT 4
+
+#if GEOMETRY == GEOMETRY_16X14
+// 0: The classic wrap-around board
+#define LEVEL_0                                                            \
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \
+   0, 0, 0, 0}
+// 1: Solid border: the edges no longer wrap
+#define LEVEL_1                                                              \
+  {255, 255, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, \
+   1, 128, 1, 128, 1, 128, 1, 128, 255, 255}
+// 2: Border with a two-cell gate in the middle of each side
+#define LEVEL_2                                                             \
+  {127, 254, 1, 128, 1, 128, 1, 128, 1, 128, 1, 128, 0, 0, 0, 0, 1, 128, 1, \
+   128, 1, 128, 1, 128, 1, 128, 127, 254}
+// 3: Gated border plus two bars across the top and bottom quarters
+#define LEVEL_3                                                            \
+  {127, 254, 1, 128, 241, 143, 1, 128, 1, 128, 1, 128, 0, 0, 0, 0, 1, 128, \
+   1, 128, 1, 128, 241, 143, 1, 128, 127, 254}
+#endif
+
+#if GEOMETRY == GEOMETRY_32X28
+// 0: The classic wrap-around board
+#define LEVEL_0                                                            \
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+// 1: Solid border: the edges no longer wrap
+#define LEVEL_1                                                           \
+  {255, 255, 255, 255, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,  \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,  \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,  \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,  \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 255, 255, 255, 255}
+// 2: Border with a two-cell gate in the middle of each side
+#define LEVEL_2                                                              \
+  {255, 127, 254, 255, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,    \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,     \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 0, 0, 0, 0, 0, 0, 0, 0, 1, \
+   0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0,  \
+   0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,  \
+   128, 1, 0, 0, 128, 255, 127, 254, 255}
+// 3: Gated border plus two bars across the top and bottom quarters
+#define LEVEL_3                                                              \
+  {255, 127, 254, 255, 1, 0, 0, 128, 1, 255, 255, 128, 1, 0, 0, 128, 1, 0,   \
+   0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0,  \
+   128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 0, 0, 0, 0, 0, 0, 0, 0, 1, \
+   0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0,  \
+   0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 0, 0, 128, 1, 255,   \
+   255, 128, 1, 0, 0, 128, 255, 127, 254, 255}
+#endif
+
+#ifndef LEVEL_0
+#error "No levels for this GEOMETRY, add it to tools/gen_levels.py"
+#endif
+
+#define LEVELS {LEVEL_0, LEVEL_1, LEVEL_2, LEVEL_3}
+
+#endif
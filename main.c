@@ -6,111 +6,328 @@
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <stdlib.h>
-#include <util/delay.h>
+#include "autopilot.h"
 #include "config.h"
 #include "display.h"
 #include "game.h"
 #include "graphic.h"
+#include "hal.h"
+#include "input.h"
+#include "level.h"
+#include "power.h"
+#include "probe.h"
+#include "random.h"
+#include "replay.h"
 #include "serial.h"
+#include "snake.h"
+#include "store.h"
+#include "timer.h"
 #include "types.h"
 
-volatile uint32_t lastMoveTime = 0;    // Timestamp of last snake movement
-volatile uint32_t lastButtonTime = 0;  // Timestamp for button debouncing
-volatile uint8_t buttonsEnabled = 1;   // Button input enable flag
-volatile uint8_t direction = INITIAL_DIRECTION;  // Current snake direction
+#define OPPONENT_NONE 0       // Solo game
+#define OPPONENT_PLAYER 1     // Second snake on the PORTC buttons
+#define OPPONENT_AUTOPILOT 2  // Second snake steered by the autopilot
+
+Schedule moveSchedule;             // Fixed-step game tick deadlines
+Replay replay;                     // Input log of the current game
+uint8_t run = STATE_PLAYING;       // Main loop state (STATE_*)
+uint8_t opponent = OPPONENT_NONE;  // Who drives the second snake
+uint8_t buttonsRaw = 0;            // Button levels last read
+uint8_t buttonsStable = 0;         // Levels unchanged for DEBOUNCE_TIME
+uint32_t buttonsChanged = 0;       // Millisecond stamp of the last change
+#if MAX_SNAKES > 1
+volatile uint8_t direction2;  // Second snake's latched direction
+#endif
 
 /**
  * @brief Initializes button inputs and enables pin change interrupts.
  * @note Configures:
  * - UP/DOWN/LEFT/RIGHT buttons as inputs with pull-ups
- * - PCINT18-21 interrupts for button pins
+ * - PORTD pin change interrupts for button pins (PCINTn = 16 + PDn)
+ * - The second player's buttons likewise on PORTC (PCINTn = 8 + PCn)
  */
 void init_buttons() {
   // Set as inputs with pull-ups
-  DDRD &= ~((1 << UP_BTN_PIN) | (1 << DOWN_BTN_PIN) | (1 << LEFT_BTN_PIN) |
-            (1 << RIGHT_BTN_PIN));
-  PORTD |= (1 << UP_BTN_PIN) | (1 << DOWN_BTN_PIN) | (1 << LEFT_BTN_PIN) |
-           (1 << RIGHT_BTN_PIN);
+  DDRD &= ~BUTTON_MASK;
+  PORTD |= BUTTON_MASK;
 
   // Enable pin change interrupts
   PCICR |= (1 << PCIE2);
-  PCMSK2 |= (1 << PCINT18) | (1 << PCINT19) | (1 << PCINT20) | (1 << PCINT21);
+  PCMSK2 |= BUTTON_MASK;
+
+#if MAX_SNAKES > 1
+  uint8_t p2 = (1 << P2_UP_BTN_PIN) | (1 << P2_DOWN_BTN_PIN) |
+               (1 << P2_LEFT_BTN_PIN) | (1 << P2_RIGHT_BTN_PIN);
+  DDRC &= ~p2;
+  PORTC |= p2;
+  PCICR |= (1 << PCIE1);
+  PCMSK1 |= p2;
+#endif
 }
 
 /**
  * @brief Initializes all hardware peripherals.
  * @note Enables:
+ * - Timer1 millisecond clock
  * - SPI interface
  * - Button inputs
+ * - Global interrupts (SPI transmit is interrupt-driven)
  * - SH1107 display
- * - Global interrupts
  */
 void hardware_init() {
+  timer_init();
   spi_init();
   init_buttons();
-  sh1107_init();
+  PROBE_INIT();
   sei();  // Enable global interrupts
+  sh1107_init();
+  store_init();
+  sh1107_set_contrast(store_contrast());
+}
+
+#ifdef BENCHMARK
+/**
+ * @brief Streams the state after a tick to the benchmark harness.
+ * @param state Pointer to the current GameState structure.
+ * @note Record: head x, head y, food x, food y, length (LE16), game over;
+ * all of the first snake.
+ */
+void report_tick(GameState* state) {
+  const Snake* snake = &(state->snakes[0]);
+  Point head = snake_head(snake);
+  PROBE_REPORT(head.x);
+  PROBE_REPORT(head.y);
+  PROBE_REPORT(state->food.x);
+  PROBE_REPORT(state->food.y);
+  PROBE_REPORT(snake->length & 0xFF);
+  PROBE_REPORT(snake->length >> 8);
+  PROBE_REPORT(state->gameOver);
+}
+#endif
+
+/**
+ * @brief Resets the game and restarts the tick schedule.
+ * @param state Pointer to the current GameState structure.
+ * @param mode REPLAY_RECORD to play live, REPLAY_PLAY to replay the log.
+ * @note The power-on choice of opponent excludes the demo and replays, so
+ * those are always solo. The demo plays the open board, where the
+ * autopilot's cycle is safe; replays restore their own level.
+ */
+void start_game(GameState* state, uint8_t mode) {
+  input_clear();
+  state->level = run == STATE_ATTRACT ? 0 : store_level();
+  replay_begin(&replay, state, mode);
+  state->snakeCount = 1;
+#if MAX_SNAKES > 1
+  if (opponent != OPPONENT_NONE) {
+    state->snakeCount = 2;
+  }
+  state->snakes[1].direction = &direction2;
+#endif
+  reset_game(state);
+  schedule_start(&moveSchedule, store_move_delay());
+}
+
+/**
+ * @brief Debounces the buttons for the state machine.
+ * @return Buttons that went down and then stayed down for DEBOUNCE_TIME.
+ * @note Turns do not wait for this; input_update() queues them at once.
+ */
+uint8_t buttons_pressed() {
+  uint8_t raw = hal_buttons();
+  uint32_t now = timer_millis();
+  if (raw != buttonsRaw) {
+    buttonsRaw = raw;
+    buttonsChanged = now;
+  }
+  if (buttonsStable == buttonsRaw || now - buttonsChanged < DEBOUNCE_TIME)
+    return 0;
+  uint8_t pressed = buttonsRaw & ~buttonsStable;
+  buttonsStable = buttonsRaw;
+  return pressed;
+}
+
+/**
+ * @brief Runs one game tick.
+ * @param state Pointer to the current GameState structure.
+ * @note Game over hands a player game to STATE_GAME_OVER; the demo simply
+ * starts again. Only solo games are saved: the replay log holds the first
+ * snake's turns alone.
+ */
+void play_tick(GameState* state) {
+  uint8_t demo = run == STATE_ATTRACT;
+  Snake* first = &(state->snakes[0]);
+  replay_tick(&replay, demo ? autopilot_direction(state, first)
+                            : input_next(0, replay.direction));
+#if MAX_SNAKES > 1
+  if (state->snakeCount > 1) {
+    direction2 = opponent == OPPONENT_AUTOPILOT
+                     ? autopilot_direction(state, &(state->snakes[1]))
+                     : input_next(1, direction2);
+  }
+#endif
+  move_snake(state);
+  render_game(state);
+#ifdef BENCHMARK
+  report_tick(state);
+#endif
+  if (!state->gameOver)
+    return;
+  if (demo) {
+    start_game(state, REPLAY_RECORD);
+    return;
+  }
+  if (replay.mode == REPLAY_RECORD && state->snakeCount == 1) {
+    replay_save(&replay);
+    store_submit_score(first->score);
+  }
+  run = STATE_GAME_OVER;
+}
+
+/**
+ * @brief Handles a press while paused: settings, or resuming.
+ * @param pressed Debounced BUTTON_* presses.
+ * @note UP and DOWN make the game faster and slower, RIGHT steps through
+ * contrast levels, LEFT resumes. Changes are saved by store_poll().
+ */
+void pause_press(uint8_t pressed) {
+  uint16_t delay = store_move_delay();
+  if (pressed & BUTTON_LEFT) {
+    // The resuming press is not a turn
+    input_clear();
+    schedule_start(&moveSchedule, delay);
+    run = STATE_PLAYING;
+  } else if ((pressed & BUTTON_UP) && delay > MOVE_DELAY_MIN) {
+    store_set_move_delay(delay - MOVE_DELAY_STEP);
+  } else if ((pressed & BUTTON_DOWN) && delay < MOVE_DELAY_MAX) {
+    store_set_move_delay(delay + MOVE_DELAY_STEP);
+  } else if (pressed & BUTTON_RIGHT) {
+    store_set_contrast(store_contrast() + CONTRAST_STEP);
+    sh1107_set_contrast(store_contrast());
+  }
 }
 
 /**
  * @brief Main game entry point.
- * @note Implements:
- * - Game state initialization
- * - Main game loop with movement timing
- * - Game over detection and reset handling
+ * @note Implements a state machine that sleeps whenever it has no work:
+ * - STATE_PLAYING: a tick every store_move_delay() ms; LEFT and RIGHT
+ *   pressed together pause
+ * - STATE_PAUSED: settings, see pause_press()
+ * - STATE_GAME_OVER: any new press starts a new game, RIGHT on the next
+ *   level, once the recording is written; the score goes into the
+ *   high-score table
+ * - STATE_ATTRACT: entered by holding RIGHT at power-on, the autopilot
+ *   plays until any button is pressed
+ * Holding UP at power-on starts two-player games on one grid, holding LEFT
+ * games against the autopilot (16x14 board only).
+ * Every game is recorded; holding DOWN at power-on replays the last
+ * recording saved to EEPROM instead. Playing and attract idle between
+ * millisecond ticks; paused and game over power down once the buttons have
+ * settled and wake on the next pin change.
  */
 int main(void) {
-  GameState* state;
-  state->direction = &direction;
-  state->score = INITIAL_SCORE;
-  state->snakeLength = INITIAL_SNAKE_LENGTH;
+  static GameState game;
+  GameState* state = &game;
 
   hardware_init();
-  reset_game(state);
+#ifdef RANDOM_SEED
+  random_seed(&(state->rng), RANDOM_SEED);
+#else
+  random_seed(&(state->rng), hal_entropy());
+#endif
+  uint8_t mode = REPLAY_RECORD;
+  if (hal_buttons() & BUTTON_RIGHT) {
+    run = STATE_ATTRACT;
+#if MAX_SNAKES > 1
+  } else if (hal_buttons() & BUTTON_UP) {
+    opponent = OPPONENT_PLAYER;
+  } else if (hal_buttons() & BUTTON_LEFT) {
+    opponent = OPPONENT_AUTOPILOT;
+#endif
+  } else if ((hal_buttons() & BUTTON_DOWN) && replay_load(&replay)) {
+    mode = REPLAY_PLAY;
+  }
+  start_game(state, mode);
+
+  // Held at power-on, so not a press: the demo must not end at once
+  buttonsRaw = buttonsStable = hal_buttons();
 
   // Main game loop
   while (1) {
-    if (!state->gameOver) {
-      // Using interrupt-based button handling
-      if (lastMoveTime++ > MOVE_DELAY) {
-        move_snake(state);
-        lastMoveTime = 0;
-        render_game(state);
-      }
-      _delay_ms(1);
+    PROBE_POLL(&moveSchedule);
+    replay_poll(&replay);
+    store_poll();
+    uint8_t pressed = buttons_pressed();
+
+    switch (run) {
+      case STATE_PLAYING:
+        if (pressed && (buttonsStable & PAUSE_BUTTONS) == PAUSE_BUTTONS) {
+          // The chord's own presses were queued as turns by the ISR
+          input_clear();
+          run = STATE_PAUSED;
+        } else if (schedule_due(&moveSchedule)) {
+          play_tick(state);
+        }
+        break;
+      case STATE_PAUSED:
+        if (pressed) {
+          pause_press(pressed);
+        }
+        break;
+      case STATE_GAME_OVER:
+        if (replay_saving(&replay)) {
+          break;  // The next game would overwrite the log being written
+        }
+        if (pressed & BUTTON_RIGHT) {
+          store_set_level((store_level() + 1) % LEVEL_COUNT);
+        }
+        if (pressed) {
+          run = STATE_PLAYING;
+          start_game(state, REPLAY_RECORD);
+        }
+        break;
+      case STATE_ATTRACT:
+        if (pressed) {
+          // Player takes over from the demo, on their own level
+          run = STATE_PLAYING;
+          start_game(state, REPLAY_RECORD);
+        } else if (schedule_due(&moveSchedule)) {
+          play_tick(state);
+        }
+        break;
+    }
+
+    // Sleep unless a tick is due or the buttons changed since they were
+    // read; with interrupts off, any event after this check ends the sleep
+    cli();
+    uint8_t ticking = run == STATE_PLAYING || run == STATE_ATTRACT;
+    if (hal_buttons() != buttonsRaw ||
+        (ticking && (int32_t)(timer_millis() - moveSchedule.deadline) >= 0)) {
+      sei();
     } else {
-      // Game over - wait for any button press to reset
-      if (!(PIND & ((1 << UP_BTN_PIN) | (1 << DOWN_BTN_PIN) |
-                    (1 << LEFT_BTN_PIN) | (1 << RIGHT_BTN_PIN)))) {
-        reset_game(state);
-      }
+      // Debouncing needs the millisecond clock, so only power down after
+      power_sleep(run, !ticking && buttonsStable == buttonsRaw);
     }
   }
 }
 
 /**
  * @brief Pin Change Interrupt handler for button inputs.
- * @note Implements:
- * - Debouncing (DEBOUNCE_TIME)
- * - Direction change logic (prevents 180° turns)
+ * @note Debouncing and turn queueing live in input_update().
  */
 ISR(PCINT2_vect) {
-  static uint32_t lastInterrupt = 0;
-  uint32_t now = lastMoveTime;
+  PROBE_ENTER(PROBE_BUTTON_ISR);
+  input_update(0, hal_buttons(), timer_millis());
+  PROBE_LEAVE(PROBE_BUTTON_ISR);
+}
 
-  if (now - lastInterrupt < DEBOUNCE_TIME)
-    return;
-  lastInterrupt = now;
-
-  uint8_t buttons = PIND;
-
-  if (!(buttons & (1 << UP_BTN_PIN)) && direction != DIRECTION_DOWN) {
-    direction = DIRECTION_UP;
-  } else if (!(buttons & (1 << DOWN_BTN_PIN)) && direction != DIRECTION_UP) {
-    direction = DIRECTION_DOWN;
-  } else if (!(buttons & (1 << LEFT_BTN_PIN)) && direction != DIRECTION_RIGHT) {
-    direction = DIRECTION_LEFT;
-  } else if (!(buttons & (1 << RIGHT_BTN_PIN)) && direction != DIRECTION_LEFT) {
-    direction = DIRECTION_RIGHT;
-  }
-}
\ No newline at end of file
+#if MAX_SNAKES > 1
+/**
+ * @brief Pin Change Interrupt handler for the second player's buttons.
+ */
+ISR(PCINT1_vect) {
+  PROBE_ENTER(PROBE_BUTTON_ISR);
+  input_update(1, hal_buttons2(), timer_millis());
+  PROBE_LEAVE(PROBE_BUTTON_ISR);
+}
+#endif
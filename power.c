@@ -0,0 +1,56 @@
+/**
+ * @file power.c
+ * @brief Sleep control for the main loop and per-state awake-time tracking.
+ * @note IDLE keeps Timer1, SPI and the pin change interrupt running, so the
+ * millisecond tick, SPI completion and buttons all wake the CPU. POWER_DOWN
+ * stops every clock; only a pin change wakes it, which is enough for the
+ * paused and game over states. Profiling builds never power down, since
+ * the USART telemetry needs the I/O clock.
+ */
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include "hal.h"
+#include "power.h"
+#include "serial.h"
+#include "timer.h"
+
+#ifdef PROFILE
+#define POWER_DOWN_ALLOWED 0
+#else
+#define POWER_DOWN_ALLOWED 1
+#endif
+
+PowerStats powerStats[STATE_COUNT];
+static uint32_t lastWake = 0;  // Cycle stamp of the last wake-up
+
+/**
+ * @brief Sleeps until the next interrupt.
+ * @param state Current STATE_* value, charged with the time spent.
+ * @param deep Non-zero to power down instead of idling.
+ * @note Call with interrupts disabled after checking that there is no work
+ * left; returns with interrupts enabled. The instruction after SEI always
+ * runs, so an interrupt arriving after the check still ends the sleep.
+ * Powering down waits for the SPI queue and EEPROM writes: their
+ * completion interrupts only wake the CPU from IDLE.
+ */
+void power_sleep(uint8_t state, uint8_t deep) {
+  PowerStats* s = &powerStats[state];
+  uint32_t now = timer_cycles();
+  s->awake += now - lastWake;
+
+  if (deep && POWER_DOWN_ALLOWED && !spi_busy() && !hal_storage_busy()) {
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  } else {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+  }
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+
+  lastWake = timer_cycles();
+  s->asleep += lastWake - now;
+  s->wakeups++;
+}
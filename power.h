@@ -0,0 +1,28 @@
+/**
+ * @file power.h
+ * @brief Header file for sleep control and per-state awake-time tracking.
+ */
+
+#ifndef SNAKE_GAME_POWER_H
+#define SNAKE_GAME_POWER_H
+
+#include <stdint.h>
+
+// Main loop states; power statistics are kept per state
+#define STATE_PLAYING 0
+#define STATE_PAUSED 1
+#define STATE_GAME_OVER 2
+#define STATE_ATTRACT 3
+#define STATE_COUNT 4
+
+typedef struct {
+  uint32_t awake;    // CPU cycles spent running
+  uint32_t asleep;   // CPU cycles spent in IDLE (POWER_DOWN stops Timer1)
+  uint16_t wakeups;  // Sleeps that ended in this state
+} PowerStats;
+
+extern PowerStats powerStats[STATE_COUNT];
+
+void power_sleep(uint8_t, uint8_t);
+
+#endif
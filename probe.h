@@ -0,0 +1,59 @@
+/**
+ * @file probe.h
+ * @brief Hot-path probes for cycle measurements of the Snake game.
+ * @note Probes compile to nothing unless BENCHMARK, PROFILE or SIMULATE is
+ * defined.
+ * - BENCHMARK: the probe id goes to GPIOR0 on entry and id | PROBE_EXIT on
+ *   exit; the simavr harness in bench/ timestamps those writes in cycles.
+ *   PROBE_REPORT streams game state bytes to the harness through GPIOR1.
+ * - PROFILE: on-target Timer1 cycle stamps feed the min/max/mean table in
+ *   profile.c, which is streamed out of USART0 by PROBE_POLL() together
+ *   with the tick overruns of the given Schedule.
+ * - SIMULATE: entry and exit call the host batch simulator in sim/.
+ */
+
+#ifndef SNAKE_GAME_PROBE_H
+#define SNAKE_GAME_PROBE_H
+
+#define PROBE_MOVE_SNAKE 1
+#define PROBE_RENDER_GAME 2
+#define PROBE_DRAW_SCORE 3
+#define PROBE_PLACE_FOOD 4
+#define PROBE_SH1107_INIT 5
+#define PROBE_DRAW_SNAKE 6
+#define PROBE_DRAW_FOOD 7
+#define PROBE_BUTTON_ISR 8
+#define PROBE_COUNT 9
+
+#define PROBE_EXIT 0x80
+
+#if defined(BENCHMARK)
+#include <avr/io.h>
+#define PROBE_ENTER(id) (GPIOR0 = (id))
+#define PROBE_LEAVE(id) (GPIOR0 = (id) | PROBE_EXIT)
+#define PROBE_REPORT(value) (GPIOR1 = (value))
+#define PROBE_INIT()
+#define PROBE_POLL(schedule)
+#elif defined(PROFILE)
+#include "profile.h"
+#define PROBE_ENTER(id) profile_enter(id)
+#define PROBE_LEAVE(id) profile_leave(id)
+#define PROBE_REPORT(value)
+#define PROBE_INIT() profile_init()
+#define PROBE_POLL(schedule) profile_poll(schedule)
+#elif defined(SIMULATE)
+#include "sim.h"
+#define PROBE_ENTER(id) sim_probe_enter(id)
+#define PROBE_LEAVE(id) sim_probe_leave(id)
+#define PROBE_REPORT(value)
+#define PROBE_INIT()
+#define PROBE_POLL(schedule)
+#else
+#define PROBE_ENTER(id)
+#define PROBE_LEAVE(id)
+#define PROBE_REPORT(value)
+#define PROBE_INIT()
+#define PROBE_POLL(schedule)
+#endif
+
+#endif
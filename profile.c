@@ -0,0 +1,171 @@
+/**
+ * @file profile.c
+ * @brief On-target profiling: Timer1 cycle stamps and USART0 telemetry.
+ * @note Only built into firmware compiled with -DPROFILE (make profile).
+ */
+
+#ifdef PROFILE
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include "config.h"
+#include "power.h"
+#include "probe.h"
+#include "profile.h"
+#include "serial.h"
+#include "timer.h"
+
+#if DISPLAY_TRANSPORT == DISPLAY_TRANSPORT_USART
+#error "PROFILE needs USART0, which the display transport is using"
+#endif
+
+// Sync, length, window, every record and the checksum
+#define FRAME_SIZE \
+  (6 + PROFILE_RECORD_BYTES * (PROBE_COUNT - 1 + STATE_COUNT + 1))
+
+#if FRAME_SIZE > 255
+#error "Telemetry frame outgrows its uint8_t length and send counters"
+#endif
+
+static ProfileStats stats[PROBE_COUNT];
+static uint32_t windowStart = 0;          // Millisecond stamp of window start
+static uint32_t bytesBefore = 0;          // spi_bytes_sent() at window start
+static uint8_t frame[FRAME_SIZE];         // Telemetry frame being sent
+static volatile uint8_t frameLength = 0;  // Bytes in frame, 0 when idle
+static volatile uint8_t frameSent = 0;    // Bytes already sent
+
+/**
+ * @brief Configures USART0 for 8N1 transmit at PROFILE_BAUD.
+ */
+void profile_init() {
+  UCSR0A = (1 << U2X0);
+  UBRR0 = F_CPU / 8 / PROFILE_BAUD - 1;
+  UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+  UCSR0B = (1 << TXEN0);
+  windowStart = timer_millis();
+}
+
+/**
+ * @brief Records the cycle stamp at probe entry.
+ * @param id Probe id (PROBE_*).
+ */
+void profile_enter(uint8_t id) {
+  stats[id].start = timer_cycles();
+}
+
+/**
+ * @brief Folds the elapsed cycles since profile_enter() into the table.
+ * @param id Probe id (PROBE_*).
+ */
+void profile_leave(uint8_t id) {
+  uint32_t cycles = timer_cycles() - stats[id].start;
+  ProfileStats* s = &stats[id];
+  if (!s->calls || cycles < s->min) {
+    s->min = cycles;
+  }
+  if (cycles > s->max) {
+    s->max = cycles;
+  }
+  s->total += cycles;
+  s->calls++;
+}
+
+/**
+ * @brief Appends a little-endian value to the frame.
+ * @param at Write position, advanced past the value.
+ * @param value Value to append.
+ * @param size Number of bytes to append.
+ */
+static void put(uint8_t* at, uint32_t value, uint8_t size) {
+  while (size--) {
+    frame[(*at)++] = value & 0xFF;
+    value >>= 8;
+  }
+}
+
+/**
+ * @brief Sends a telemetry frame every PROFILE_PERIOD_MS and starts a new
+ * measurement window.
+ * @param schedule Game tick schedule; its overruns are reported and cleared.
+ * @note Skips the window if the previous frame is still being sent.
+ */
+void profile_poll(Schedule* schedule) {
+  uint32_t now = timer_millis();
+  if (now - windowStart < PROFILE_PERIOD_MS || frameLength) {
+    return;
+  }
+
+  uint8_t at = 3;
+  put(&at, now - windowStart, 2);
+
+  uint8_t sreg = SREG;
+  cli();
+  for (uint8_t id = 1; id < PROBE_COUNT; id++) {
+    ProfileStats* s = &stats[id];
+    if (!s->calls) {
+      continue;
+    }
+    put(&at, id, 1);
+    put(&at, s->calls, 2);
+    put(&at, s->min, 4);
+    put(&at, s->max, 4);
+    put(&at, s->total / s->calls, 4);
+    s->calls = 0;
+    s->total = 0;
+    s->max = 0;
+  }
+  SREG = sreg;
+
+  // Main loop states, charged by power_sleep() from this same context
+  for (uint8_t id = 0; id < STATE_COUNT; id++) {
+    PowerStats* p = &powerStats[id];
+    if (!p->wakeups) {
+      continue;
+    }
+    uint32_t total = p->awake + p->asleep;
+    put(&at, PROFILE_STATE_ID + id, 1);
+    put(&at, p->wakeups, 2);
+    put(&at, p->awake, 4);
+    put(&at, p->asleep, 4);
+    put(&at, total < 1000 ? 1000 : p->awake / (total / 1000), 4);
+    p->wakeups = 0;
+    p->awake = 0;
+    p->asleep = 0;
+  }
+
+  put(&at, PROFILE_SYSTEM_ID, 1);
+  put(&at, schedule->overruns, 2);
+  put(&at, spi_high_water(), 4);
+  uint32_t bytes = spi_bytes_sent();
+  put(&at, bytes - bytesBefore, 4);
+  put(&at, bytes, 4);
+  bytesBefore = bytes;
+  schedule->overruns = 0;
+
+  uint8_t sum = 0;
+  for (uint8_t i = 3; i < at; i++) {
+    sum += frame[i];
+  }
+  frame[0] = PROFILE_SYNC_0;
+  frame[1] = PROFILE_SYNC_1;
+  frame[2] = at - 3;
+  frame[at++] = sum;
+
+  windowStart = now;
+  frameSent = 0;
+  frameLength = at;
+  UCSR0B |= (1 << UDRIE0);
+}
+
+/**
+ * @brief USART Data Register Empty handler, sends the next frame byte.
+ */
+ISR(USART_UDRE_vect) {
+  UDR0 = frame[frameSent++];
+  if (frameSent == frameLength) {
+    UCSR0B &= ~(1 << UDRIE0);
+    frameLength = 0;
+  }
+}
+
+#endif
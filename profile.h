@@ -0,0 +1,45 @@
+/**
+ * @file profile.h
+ * @brief Header file for on-target profiling with UART telemetry.
+ */
+
+#ifndef SNAKE_GAME_PROFILE_H
+#define SNAKE_GAME_PROFILE_H
+
+#include <stdint.h>
+#include "timer.h"
+
+#define PROFILE_BAUD 115200
+#define PROFILE_PERIOD_MS 1000  // Telemetry frame interval
+
+// Telemetry frame: sync, payload length, payload, 8-bit sum of payload.
+// Payload: window length in ms (u16), then per active probe:
+// id (u8), calls (u16), min, max, mean cycles (u32 each). Little endian.
+// Then per main loop state that slept: PROFILE_STATE_ID + STATE_* (u8),
+// wake-ups (u16), awake cycles, asleep cycles, awake per mille (u32 each).
+// Last, one PROFILE_SYSTEM_ID record: game tick overruns (u16), display
+// queue high water since boot, display bytes sent in the window and since
+// boot (u32 each).
+#define PROFILE_SYNC_0 0xA5
+#define PROFILE_SYNC_1 0x5A
+#define PROFILE_RECORD_BYTES 15
+#define PROFILE_STATE_ID 0x40
+#define PROFILE_SYSTEM_ID 0x50
+
+typedef struct {
+  uint32_t start;  // Cycle stamp of the open call
+  uint32_t min;
+  uint32_t max;
+  uint32_t total;
+  uint16_t calls;
+} ProfileStats;
+
+void profile_init();
+
+void profile_enter(uint8_t);
+
+void profile_leave(uint8_t);
+
+void profile_poll(Schedule*);
+
+#endif
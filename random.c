@@ -0,0 +1,53 @@
+/**
+ * @file random.c
+ * @brief 16-bit xorshift random number generator (shifts 7, 9, 8).
+ * @note State lives with the caller, so every game owns a reproducible
+ * stream. Shifts and XORs only; no multiply or divide on the AVR.
+ */
+
+#include "random.h"
+
+/**
+ * @brief Seeds a generator.
+ * @param rng Pointer to the generator state.
+ * @param seed Seed value; 0 is replaced by RANDOM_DEFAULT_SEED.
+ */
+void random_seed(uint16_t* rng, uint16_t seed) {
+  *rng = seed ? seed : RANDOM_DEFAULT_SEED;
+}
+
+/**
+ * @brief Advances a generator.
+ * @param rng Pointer to the generator state.
+ * @return Next value in 1..65535 (period 65535).
+ */
+uint16_t random_next(uint16_t* rng) {
+  uint16_t x = *rng;
+  x ^= x << 7;
+  x ^= x >> 9;
+  x ^= x << 8;
+  *rng = x;
+  return x;
+}
+
+/**
+ * @brief Draws an unbiased value below a bound.
+ * @param rng Pointer to the generator state.
+ * @param bound Exclusive upper bound (must be non-zero).
+ * @return Value in 0..bound-1.
+ * @note Masks to the next power of two and rejects values out of range,
+ * so fewer than two draws are needed on average.
+ */
+uint16_t random_range(uint16_t* rng, uint16_t bound) {
+  uint16_t mask = bound - 1;
+  mask |= mask >> 1;
+  mask |= mask >> 2;
+  mask |= mask >> 4;
+  mask |= mask >> 8;
+
+  uint16_t value;
+  do {
+    value = random_next(rng) & mask;
+  } while (value >= bound);
+  return value;
+}
@@ -0,0 +1,19 @@
+/**
+ * @file random.h
+ * @brief Header file for the 16-bit xorshift random number generator.
+ */
+
+#ifndef SNAKE_GAME_RANDOM_H
+#define SNAKE_GAME_RANDOM_H
+
+#include <stdint.h>
+
+#define RANDOM_DEFAULT_SEED 0xACE1  // Substituted for the invalid seed 0
+
+void random_seed(uint16_t*, uint16_t);
+
+uint16_t random_next(uint16_t*);
+
+uint16_t random_range(uint16_t*, uint16_t);
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file replay.c
+ * @brief Deterministic input recording and replay for the Snake game.
+ * @note A game is fully determined by the level, the generator state at
+ * reset_game and the direction move_snake sees on every tick. The recorder
+ * logs only changes of that direction, two bytes each: the gap in ticks since
+ * the previous change and the new direction. While playing back, the log
+ * replaces the button ISR, so the replayed game - and every frame it
+ * draws - is identical to the recorded one.
+ */
+
+#include "hal.h"
+#include "replay.h"
+
+/**
+ * @brief Starts recording or playing back a game.
+ * @param replay Pointer to the recording.
+ * @param state Pointer to the GameState about to be reset.
+ * @param mode REPLAY_RECORD or REPLAY_PLAY.
+ * @note Call before reset_game: recording captures the generator state the
+ * reset draws food from and the level, playback restores both. Either way
+ * the first snake is pointed at the latched direction, so the ISR cannot
+ * change it mid-tick.
+ */
+void replay_begin(Replay* replay, GameState* state, uint8_t mode) {
+  replay->mode = mode;
+  replay->direction = INITIAL_DIRECTION;
+  replay->tick = 0;
+  replay->eventTick = 0;
+  replay->cursor = 0;
+  if (mode == REPLAY_PLAY) {
+    state->rng = replay->seed;
+    state->level = replay->level;
+  } else {
+    replay->seed = state->rng;
+    replay->level = state->level;
+    replay->count = 0;
+    replay->overflow = 0;
+  }
+  state->snakes[0].direction = &(replay->direction);
+}
+
+/**
+ * @brief Appends an event to the recording.
+ * @param replay Pointer to the recording.
+ * @param delta Ticks since the previous event (at most REPLAY_MAX_DELTA).
+ * @param direction Direction that takes effect.
+ */
+static void append(Replay* replay, uint16_t delta, uint8_t direction) {
+  if (replay->count >= REPLAY_CAPACITY) {
+    replay->overflow = 1;
+    return;
+  }
+  replay->events[replay->count++] = (delta << 2) | direction;
+}
+
+/**
+ * @brief Latches the direction for the next move_snake call.
+ * @param replay Pointer to the recording.
+ * @param input Direction for this tick from input_next().
+ * @note Recording logs input when it differs from the previous tick;
+ * gaps longer than REPLAY_MAX_DELTA are bridged by repeating the current
+ * direction. Playback ignores input and applies every event due this tick.
+ */
+void replay_tick(Replay* replay, uint8_t input) {
+  if (replay->mode == REPLAY_PLAY) {
+    while (replay->cursor < replay->count) {
+      uint16_t event = replay->events[replay->cursor];
+      if ((uint16_t)(replay->tick - replay->eventTick) != (event >> 2))
+        break;
+      replay->eventTick = replay->tick;
+      replay->direction = event & 0x03;
+      replay->cursor++;
+    }
+  } else if (input != replay->direction) {
+    while ((uint16_t)(replay->tick - replay->eventTick) > REPLAY_MAX_DELTA) {
+      append(replay, REPLAY_MAX_DELTA, replay->direction);
+      replay->eventTick += REPLAY_MAX_DELTA;
+    }
+    append(replay, replay->tick - replay->eventTick, input);
+    replay->eventTick = replay->tick;
+    replay->direction = input;
+  }
+  replay->tick++;
+}
+
+/**
+ * @brief Queues a finished recording for non-volatile storage.
+ * @param replay Pointer to the recording.
+ * @return 1 if queued, 0 if the recording overflowed and was dropped.
+ * @note Layout at REPLAY_EEPROM_ADDR: magic, seed, count, level, events
+ * (LE16), written in the background by the EEPROM ready interrupt. The
+ * recording must not change until replay_saving() returns 0.
+ */
+uint8_t replay_save(Replay* replay) {
+  if (replay->overflow)
+    return 0;
+  replay->header[0] = REPLAY_MAGIC;
+  replay->header[1] = replay->seed;
+  replay->header[2] = replay->count;
+  replay->header[3] = replay->level;
+  replay->saving = REPLAY_SAVE_PENDING;
+  replay_poll(replay);
+  return 1;
+}
+
+/**
+ * @brief Starts writing a queued recording once the EEPROM is free.
+ * @param replay Pointer to the recording.
+ * @note Call from the main loop before store_poll(), so a recording queued
+ * at game over goes out ahead of the high score it set.
+ */
+void replay_poll(Replay* replay) {
+  if (replay->saving != REPLAY_SAVE_PENDING || hal_storage_busy())
+    return;
+  hal_storage_post(REPLAY_EEPROM_ADDR, replay->header,
+                   REPLAY_HEADER_BYTES +
+                       replay->count * sizeof(replay->events[0]));
+  replay->saving = REPLAY_SAVE_POSTED;
+}
+
+/**
+ * @brief Tells whether a recording is still queued or being written.
+ * @param replay Pointer to the recording.
+ * @return Non-zero until the whole recording is in storage.
+ */
+uint8_t replay_saving(Replay* replay) {
+  if (replay->saving == REPLAY_SAVE_POSTED && !hal_storage_busy()) {
+    replay->saving = REPLAY_SAVE_IDLE;
+  }
+  return replay->saving;
+}
+
+/**
+ * @brief Reads the saved recording back from non-volatile storage.
+ * @param replay Pointer to the recording to fill.
+ * @return 1 if a valid recording was loaded, 0 otherwise.
+ */
+uint8_t replay_load(Replay* replay) {
+  uint16_t header[REPLAY_HEADER_WORDS];
+  hal_storage_read(REPLAY_EEPROM_ADDR, header, REPLAY_HEADER_BYTES);
+  if (header[0] != REPLAY_MAGIC || header[2] > REPLAY_CAPACITY)
+    return 0;
+  replay->seed = header[1];
+  replay->count = header[2];
+  replay->level = header[3];
+  replay->overflow = 0;
+  hal_storage_read(REPLAY_EEPROM_ADDR + REPLAY_HEADER_BYTES, replay->events,
+                   replay->count * sizeof(replay->events[0]));
+  return 1;
+}
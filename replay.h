@@ -0,0 +1,53 @@
+/**
+ * @file replay.h
+ * @brief Header file for deterministic input recording and replay.
+ */
+
+#ifndef SNAKE_GAME_REPLAY_H
+#define SNAKE_GAME_REPLAY_H
+
+#include <stdint.h>
+#include "config.h"
+#include "types.h"
+
+#define REPLAY_RECORD 0  // Log the live input direction every tick
+#define REPLAY_PLAY 1    // Feed the logged directions back instead
+
+#define REPLAY_MAGIC 0x524C      // "RL", marks a saved recording
+#define REPLAY_MAX_DELTA 0x3FFF  // Longest tick gap one event can hold
+#define REPLAY_HEADER_WORDS 4    // Magic, seed, count, level
+#define REPLAY_HEADER_BYTES (REPLAY_HEADER_WORDS * 2)
+
+#define REPLAY_SAVE_IDLE 0     // Nothing to write
+#define REPLAY_SAVE_PENDING 1  // Waiting for the EEPROM to be free
+#define REPLAY_SAVE_POSTED 2   // Being written by the EEPROM interrupt
+
+typedef struct {
+  uint8_t mode;        // REPLAY_RECORD or REPLAY_PLAY
+  uint8_t direction;   // Direction latched for the current tick
+  uint8_t overflow;    // Recording ran out of events
+  uint8_t saving;      // REPLAY_SAVE_*
+  uint16_t tick;       // Ticks since replay_begin
+  uint16_t eventTick;  // Tick of the last recorded or played event
+  uint16_t cursor;     // Next event to play
+  uint16_t seed;       // Generator state the game was reset with
+  uint8_t level;       // Level the game was played on
+  uint16_t count;      // Events logged
+  // Saved as one block: the header must directly precede the events
+  uint16_t header[REPLAY_HEADER_WORDS];  // Magic, seed, count, level
+  uint16_t events[REPLAY_CAPACITY];      // (tick delta << 2) | direction
+} Replay;
+
+void replay_begin(Replay*, GameState*, uint8_t);
+
+void replay_tick(Replay*, uint8_t);
+
+uint8_t replay_save(Replay*);
+
+void replay_poll(Replay*);
+
+uint8_t replay_saving(Replay*);
+
+uint8_t replay_load(Replay*);
+
+#endif
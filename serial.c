@@ -1,32 +1,290 @@
 /**
  * @file serial.c
  * @brief SPI (Serial Peripheral Interface) driver for AVR microcontrollers.
+ * @note Bytes are queued with their DC level and clocked out from interrupt
+ * handlers, so callers never wait on the bus unless the queue is full. CS
+ * stays low for as long as the queue has bytes, or between spi_begin() and
+ * spi_end(). The bus is either the SPI
+ * module or USART0 in Master SPI mode, chosen by DISPLAY_TRANSPORT.
  */
 
+#include <avr/interrupt.h>
 #include <avr/io.h>
 #include "config.h"
+#include "serial.h"
+
+static volatile uint8_t queue[SPI_QUEUE_SIZE];      // Pending bytes
+static volatile uint8_t modes[SPI_QUEUE_SIZE / 8];  // DC bit per byte
+static volatile uint8_t queueHead = 0;              // Next free slot
+static volatile uint8_t queueTail = 0;              // Next byte to send
+static volatile uint8_t busy = 0;                   // Transfer in flight
+static volatile uint8_t held = 0;                   // CS held by caller
+static uint8_t highWater = 0;                       // Deepest queue seen
+static volatile uint32_t bytesSent = 0;             // Bytes put on the bus
+
+/**
+ * @brief Returns the DC mode of the oldest queued byte.
+ * @return SPI_MODE_COMMAND or SPI_MODE_DATA.
+ */
+static uint8_t queue_mode() {
+  uint8_t slot = queueTail;
+  return (modes[slot >> 3] >> (slot & 7)) & 1;
+}
+
+/**
+ * @brief Drives the DC pin to the given mode.
+ * @param mode SPI_MODE_COMMAND or SPI_MODE_DATA.
+ */
+static void set_dc(uint8_t mode) {
+  if (mode) {
+    PORTB |= (1 << DC_PIN);  // DC high for data mode
+  } else {
+    PORTB &= ~(1 << DC_PIN);  // DC low for command mode
+  }
+}
+
+/**
+ * @brief Removes the oldest byte from the queue.
+ * @return The byte to transmit.
+ */
+static uint8_t dequeue() {
+  uint8_t slot = queueTail;
+  queueTail = (slot + 1) & SPI_QUEUE_MASK;
+  bytesSent++;
+  return queue[slot];
+}
+
+#if DISPLAY_TRANSPORT == DISPLAY_TRANSPORT_USART
+
+/**
+ * @brief Initializes USART0 as an SPI master (MSPIM) at fosc/2.
+ * Configures:
+ * - TXD0 (PD1, MOSI), XCK0 (PD4, SCK), CS_PIN, DC_PIN, RES_PIN as outputs.
+ * - SPI mode 0, MSB first, transmitter only.
+ * - Sets CS_PIN high (inactive) by default.
+ */
+void spi_init() {
+  DDRB |= (1 << CS_PIN) | (1 << DC_PIN) | (1 << RES_PIN);
+  PORTB |= (1 << CS_PIN);
+  UBRR0 = 0;
+  DDRD |= (1 << PD1) | (1 << PD4);  // XCK0 as output selects master mode
+  UCSR0C = (1 << UMSEL01) | (1 << UMSEL00);
+  UCSR0B = (1 << TXEN0);
+  UBRR0 = 0;  // Baud = fosc / (2 * (UBRR0 + 1))
+}
+
+/**
+ * @brief Loads queued bytes into the USART transmit buffer.
+ * @note Must be called with interrupts disabled. Stops at a DC change and
+ * waits for Transmit Complete, since DC may only switch on an idle line.
+ */
+static void usart_fill() {
+  while (queueTail != queueHead) {
+    if (queue_mode() != ((PORTB >> DC_PIN) & 1)) {
+      UCSR0B = (UCSR0B & ~(1 << UDRIE0)) | (1 << TXCIE0);
+      return;
+    }
+    if (!(UCSR0A & (1 << UDRE0))) {
+      UCSR0B |= (1 << UDRIE0);
+      return;
+    }
+    UCSR0A |= (1 << TXC0);  // Clear a stale Transmit Complete flag
+    UDR0 = dequeue();
+  }
+  UCSR0B = (UCSR0B & ~(1 << UDRIE0)) | (1 << TXCIE0);
+}
+
+/**
+ * @brief Starts draining the queue on an idle bus.
+ * @note Must be called with interrupts disabled and the queue non-empty.
+ */
+static void spi_start() {
+  PORTB &= ~(1 << CS_PIN);  // CS low to enable SPI
+  set_dc(queue_mode());
+  usart_fill();
+}
+
+/**
+ * @brief USART Data Register Empty handler, refills the TX buffer.
+ */
+ISR(USART_UDRE_vect) {
+  usart_fill();
+}
+
+/**
+ * @brief USART Transmit Complete handler, switches DC or ends the frame.
+ * @note Releases CS once the queue has drained.
+ */
+ISR(USART_TX_vect) {
+  UCSR0B &= ~(1 << TXCIE0);
+  if (queueTail != queueHead) {
+    set_dc(queue_mode());
+    usart_fill();
+  } else {
+    busy = 0;
+    if (!held) {
+      PORTB |= (1 << CS_PIN);  // CS high to end transaction
+    }
+  }
+}
+
+#else
 
 /**
  * @brief Initializes the SPI interface in master mode.
  * Configures:
  * - MOSI (PB3), SCK (PB5), CS_PIN, DC_PIN, and RES_PIN as outputs.
- * - SPI control register (SPCR) for master mode, clock speed (fosc/16).
+ * - SPI control register (SPCR) for master mode, clock speed (fosc/16),
+ *   with the Transfer Complete interrupt enabled.
  * - Sets CS_PIN high (inactive) by default.
  */
 void spi_init() {
   DDRB |=
       (1 << PB3) | (1 << PB5) | (1 << CS_PIN) | (1 << DC_PIN) | (1 << RES_PIN);
-  SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR0);
+  SPCR = (1 << SPIE) | (1 << SPE) | (1 << MSTR) | (1 << SPR0);
   PORTB |= (1 << CS_PIN);
 }
 
 /**
- * @brief Transmits a single byte over SPI.
+ * @brief Moves the oldest queued byte onto the bus.
+ * @note Must be called with interrupts disabled and the queue non-empty.
+ */
+static void spi_send_next() {
+  set_dc(queue_mode());
+  SPDR = dequeue();
+}
+
+/**
+ * @brief Starts draining the queue on an idle bus.
+ * @note Must be called with interrupts disabled and the queue non-empty.
+ */
+static void spi_start() {
+  PORTB &= ~(1 << CS_PIN);  // CS low to enable SPI
+  spi_send_next();
+}
+
+/**
+ * @brief SPI Transfer Complete handler, sends the next queued byte.
+ * @note Releases CS once the queue has drained.
+ */
+ISR(SPI_STC_vect) {
+  if (queueTail != queueHead) {
+    spi_send_next();
+  } else {
+    busy = 0;
+    if (!held) {
+      PORTB |= (1 << CS_PIN);  // CS high to end transaction
+    }
+  }
+}
+
+#endif
+
+/**
+ * @brief Appends a byte to the transmit queue and starts the bus if idle.
+ * @param data The byte to transmit.
+ * @param mode SPI_MODE_COMMAND or SPI_MODE_DATA.
+ * @note Blocks only while the queue is full.
+ */
+static void spi_queue(uint8_t data, uint8_t mode) {
+  uint8_t slot = queueHead;
+  uint8_t next = (slot + 1) & SPI_QUEUE_MASK;
+  while (next == queueTail)
+    ;
+
+  queue[slot] = data;
+  if (mode) {
+    modes[slot >> 3] |= (1 << (slot & 7));
+  } else {
+    modes[slot >> 3] &= ~(1 << (slot & 7));
+  }
+
+  uint8_t sreg = SREG;
+  cli();
+  queueHead = next;
+  uint8_t depth = (next - queueTail) & SPI_QUEUE_MASK;
+  if (depth > highWater) {
+    highWater = depth;
+  }
+  if (!busy) {
+    busy = 1;
+    spi_start();
+  }
+  SREG = sreg;
+}
+
+/**
+ * @brief Queues a data byte (DC high) for transmission.
  * @param data The byte to transmit.
- * @note Blocks until transmission completes (SPI busy-wait).
  */
 void spi_write(uint8_t data) {
-  SPDR = data;
-  while (!(SPSR & (1 << SPIF)))
+  spi_queue(data, SPI_MODE_DATA);
+}
+
+/**
+ * @brief Queues a command byte (DC low) for transmission.
+ * @param cmd The byte to transmit.
+ */
+void spi_command(uint8_t cmd) {
+  spi_queue(cmd, SPI_MODE_COMMAND);
+}
+
+/**
+ * @brief Opens a transaction: CS stays low until spi_end().
+ */
+void spi_begin() {
+  uint8_t sreg = SREG;
+  cli();
+  held = 1;
+  PORTB &= ~(1 << CS_PIN);  // CS low to enable SPI
+  SREG = sreg;
+}
+
+/**
+ * @brief Closes a transaction; CS is released once the queue drains.
+ */
+void spi_end() {
+  uint8_t sreg = SREG;
+  cli();
+  held = 0;
+  if (!busy) {
+    PORTB |= (1 << CS_PIN);  // CS high to end transaction
+  }
+  SREG = sreg;
+}
+
+/**
+ * @brief Waits until every queued byte has been clocked out.
+ */
+void spi_flush() {
+  while (busy)
     ;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Tells whether bytes are still queued or on the bus.
+ * @return Non-zero while a transfer is in flight.
+ */
+uint8_t spi_busy() {
+  return busy;
+}
+
+/**
+ * @brief Returns the deepest queue occupancy seen since boot.
+ * @return High-water mark in bytes, for sizing SPI_QUEUE_SIZE.
+ */
+uint8_t spi_high_water() {
+  return highWater;
+}
+
+/**
+ * @brief Returns the number of bytes put on the bus since boot.
+ * @return Byte count, for comparing transport throughput.
+ */
+uint32_t spi_bytes_sent() {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t sent = bytesSent;
+  SREG = sreg;
+  return sent;
+}
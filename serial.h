@@ -8,8 +8,28 @@
 
 #include <stdint.h>
 
+#define SPI_QUEUE_SIZE 64  // Power of two, multiple of 8
+#define SPI_QUEUE_MASK (SPI_QUEUE_SIZE - 1)
+
+#define SPI_MODE_COMMAND 0  // DC low
+#define SPI_MODE_DATA 1     // DC high
+
 void spi_init();
 
 void spi_write(uint8_t);
 
-#endif
\ No newline at end of file
+void spi_command(uint8_t);
+
+void spi_begin();
+
+void spi_end();
+
+void spi_flush();
+
+uint8_t spi_busy();
+
+uint8_t spi_high_water();
+
+uint32_t spi_bytes_sent();
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * @file render.c
+ * @brief Rendering stubs for the headless batch simulator.
+ * @note Stand in for the graphic.c entry points game.c calls, so the game
+ * core links without a display and keeps no shared frame buffers between
+ * threads.
+ */
+
+#include "graphic.h"
+
+void draw_score_label(uint8_t players) {}
+
+void draw_score(uint8_t slot, uint16_t* score) {}
+
+void clear_play_area() {}
+
+void draw_walls(const uint8_t* map) {}
+
+void flush_frame() {}
+
+void draw_snake(GameState* state) {}
+
+void draw_food(GameState* state) {}
@@ -0,0 +1,430 @@
+/**
+ * @file sim.c
+ * @brief Headless batch simulator: millions of seeded games on all cores.
+ * @note Runs the game core (game.c, grid.c, snake.c, random.c) with
+ * rendering stubbed out. Game i is seeded from the base seed and i alone,
+ * so results do not depend on the thread count or on which worker ran it.
+ * Workers own a range of game indices and steal the upper half of the
+ * busiest worker's range when they run dry.
+ *
+ * Prints a summary to stderr and CSV histograms to stdout:
+ * histogram,bucket,count for score, length, tick_ns (log2 buckets, sampled
+ * every LATENCY_SAMPLE ticks) and place_food_retries.
+ *
+ * Usage: snake_sim [-g games] [-t threads] [-s seed] [-m ticks] [-a] [-2]
+ *                  [-l level] [-e] [-M score]
+ * - -g  Number of games to play (default 1000000).
+ * - -t  Worker threads (default: online CPUs).
+ * - -s  Base seed (default 1).
+ * - -m  Tick limit per game (default 20000).
+ * - -a  Drive with the autopilot instead of the greedy driver.
+ * - -2  Two snakes on one grid, both with the same driver (16x14 only);
+ *       score and length count the first snake.
+ * - -l  Level to play (default 0, the open board).
+ * - -e  Exit with status 1 if any game hit the tick limit, e.g. a driver
+ *       circling without ever reaching the food (see make simcheck).
+ * - -M  Exit with status 1 if the mean score is below this, e.g. a driver
+ *       that traps itself long before the board is full.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "autopilot.h"
+#include "config.h"
+#include "game.h"
+#include "grid.h"
+#include "probe.h"
+#include "random.h"
+#include "snake.h"
+#include "types.h"
+
+#define CLAIM_GAMES 64       // Games taken from a worker's own range at once
+#define LATENCY_SAMPLE 64    // Time every n-th tick
+#define LATENCY_BUCKETS 32   // log2 nanoseconds
+#define RETRY_BUCKETS 16     // Rejected draws per place_food, last is "more"
+#define RETRY_LIMIT 1024     // Give up counting generator steps beyond this
+
+typedef struct {
+  uint64_t games;
+  uint64_t ticks;
+  uint64_t timeouts;                  // Games stopped by the tick limit
+  uint64_t foods;                     // place_food calls
+  uint64_t draws;                     // Generator steps in place_food
+  uint64_t score[GRID_CELLS + 1];
+  uint64_t length[GRID_CELLS + 1];
+  uint64_t latency[LATENCY_BUCKETS];
+  uint64_t retries[RETRY_BUCKETS];
+} Stats;
+
+typedef struct {
+  pthread_mutex_t lock;
+  uint64_t next;  // First unclaimed game index
+  uint64_t end;   // One past the last game index in this range
+  pthread_t thread;
+  Stats stats;
+} Worker;
+
+static Worker* workers;
+static int workerCount;
+static uint16_t baseSeed = 1;
+static uint32_t tickLimit = 20000;
+static uint8_t autopilot = 0;
+static uint8_t snakes = 1;
+static uint8_t level = 0;
+static uint8_t failOnTimeout = 0;
+static double minScore = 0;
+
+static __thread Stats* threadStats;      // Stats of the running worker
+static __thread GameState* threadState;  // Game the running worker plays
+static __thread uint16_t foodRng;        // Generator state on place_food entry
+
+/**
+ * @brief Derives a 16-bit seed for one stream of one game.
+ * @param game Game index.
+ * @param stream 0 for food placement, 1 for the driver.
+ * @return Seed (0 is remapped by random_seed).
+ */
+static uint16_t game_seed(uint64_t game, uint8_t stream) {
+  uint64_t x = game * 2 + stream + ((uint64_t)baseSeed << 40);
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  return (uint16_t)x;
+}
+
+void sim_probe_enter(uint8_t id) {
+  if (id == PROBE_PLACE_FOOD) {
+    foodRng = threadState->rng;
+  }
+}
+
+/**
+ * @brief Counts the generator steps place_food took.
+ * @note Every step past the first is a rejected draw in random_range.
+ */
+void sim_probe_leave(uint8_t id) {
+  if (id != PROBE_PLACE_FOOD) {
+    return;
+  }
+  uint16_t steps = 0;
+  while (foodRng != threadState->rng && steps < RETRY_LIMIT) {
+    random_next(&foodRng);
+    steps++;
+  }
+  uint16_t retries = steps ? steps - 1 : 0;
+  threadStats->foods++;
+  threadStats->draws += steps;
+  threadStats->retries[retries < RETRY_BUCKETS ? retries
+                                               : RETRY_BUCKETS - 1]++;
+}
+
+/**
+ * @brief Wrapped distance between two coordinates on the grid.
+ * @param size GRID_WIDTH or GRID_HEIGHT.
+ */
+static uint8_t wrap_distance(uint8_t a, uint8_t b, uint8_t size) {
+  uint8_t d = a > b ? a - b : b - a;
+  return d < size - d ? d : size - d;
+}
+
+/**
+ * @brief Greedy driver: the safe move closest to the food.
+ * @param state Pointer to the current GameState structure.
+ * @param snake Pointer to the Snake to steer.
+ * @param rng Driver generator, breaks ties.
+ * @return Direction for this tick; the snake's heading if every move
+ * collides.
+ */
+static uint8_t steer(GameState* state, const Snake* snake, uint16_t* rng) {
+  uint8_t heading = *(snake->direction);
+  Point head = snake_head(snake);
+  uint8_t best = heading;
+  uint8_t bestDistance = 0xFF;
+  for (uint8_t d = 0; d < 4; d++) {
+    if (d == (heading ^ 2)) {
+      continue;  // Reverse
+    }
+    Point next = snake_step(head, d);
+    if (check_collision(state, next)) {
+      continue;
+    }
+    uint8_t distance = wrap_distance(next.x, state->food.x, GRID_WIDTH) +
+                       wrap_distance(next.y, state->food.y, GRID_HEIGHT);
+    if (distance < bestDistance ||
+        (distance == bestDistance && (random_next(rng) & 1))) {
+      best = d;
+      bestDistance = distance;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Returns the current monotonic time in nanoseconds.
+ */
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Plays one game to game over or the tick limit.
+ * @param game Game index.
+ * @param stats Stats of the running worker.
+ */
+static void play(uint64_t game, Stats* stats) {
+  GameState state;
+  volatile uint8_t headings[MAX_SNAKES];
+  uint16_t driverRng;
+  memset(&state, 0, sizeof(state));
+  state.snakeCount = snakes;
+  state.level = level;
+  for (uint8_t i = 0; i < MAX_SNAKES; i++) {
+    state.snakes[i].direction = &headings[i];
+  }
+  threadState = &state;
+  random_seed(&(state.rng), game_seed(game, 0));
+  random_seed(&driverRng, game_seed(game, 1));
+  reset_game(&state);
+
+  uint32_t tick = 0;
+  while (!state.gameOver && tick < tickLimit) {
+    for (uint8_t i = 0; i < state.snakeCount; i++) {
+      Snake* snake = &(state.snakes[i]);
+      headings[i] = autopilot ? autopilot_direction(&state, snake)
+                              : steer(&state, snake, &driverRng);
+    }
+    if (tick % LATENCY_SAMPLE == 0) {
+      uint64_t start = now_ns();
+      move_snake(&state);
+      uint64_t ns = now_ns() - start;
+      uint8_t bucket = 0;
+      while (ns >>= 1) {
+        bucket++;
+      }
+      stats->latency[bucket < LATENCY_BUCKETS ? bucket
+                                              : LATENCY_BUCKETS - 1]++;
+    } else {
+      move_snake(&state);
+    }
+    tick++;
+  }
+
+  stats->games++;
+  stats->ticks += tick;
+  stats->timeouts += !state.gameOver;
+  Snake* first = &(state.snakes[0]);
+  stats->score[first->score <= GRID_CELLS ? first->score : GRID_CELLS]++;
+  stats->length[first->length]++;
+}
+
+/**
+ * @brief Claims games from a worker's own range.
+ * @return Number of games claimed, starting at *first.
+ */
+static uint64_t claim(Worker* worker, uint64_t* first) {
+  pthread_mutex_lock(&(worker->lock));
+  uint64_t count = worker->end - worker->next;
+  if (count > CLAIM_GAMES) {
+    count = CLAIM_GAMES;
+  }
+  *first = worker->next;
+  worker->next += count;
+  pthread_mutex_unlock(&(worker->lock));
+  return count;
+}
+
+/**
+ * @brief Moves the upper half of the busiest worker's range to self.
+ * @return 0 once no worker has games left.
+ */
+static int steal(Worker* self) {
+  while (1) {
+    Worker* victim = NULL;
+    uint64_t most = 0;
+    for (int i = 0; i < workerCount; i++) {
+      uint64_t left = workers[i].end - workers[i].next;  // Racy hint only
+      if (&workers[i] != self && left > most) {
+        victim = &workers[i];
+        most = left;
+      }
+    }
+    if (!victim) {
+      return 0;
+    }
+
+    pthread_mutex_lock(&(victim->lock));
+    uint64_t left = victim->end - victim->next;
+    uint64_t first = victim->end - (left + 1) / 2;
+    uint64_t end = victim->end;
+    victim->end = first;
+    pthread_mutex_unlock(&(victim->lock));
+    if (first == end) {
+      continue;  // Drained while we looked; pick again
+    }
+
+    pthread_mutex_lock(&(self->lock));
+    self->next = first;
+    self->end = end;
+    pthread_mutex_unlock(&(self->lock));
+    return 1;
+  }
+}
+
+/**
+ * @brief Worker thread: plays its range, then steals until all are done.
+ */
+static void* work(void* arg) {
+  Worker* self = arg;
+  threadStats = &(self->stats);
+  do {
+    uint64_t first, count;
+    while ((count = claim(self, &first))) {
+      for (uint64_t game = first; game < first + count; game++) {
+        play(game, &(self->stats));
+      }
+    }
+  } while (steal(self));
+  return NULL;
+}
+
+/**
+ * @brief Prints one histogram as CSV, skipping empty buckets.
+ */
+static void print_histogram(const char* name, const uint64_t* counts,
+                            int buckets, int log2) {
+  for (int i = 0; i < buckets; i++) {
+    if (counts[i]) {
+      printf("%s,%llu,%llu\n", name,
+             log2 ? (unsigned long long)1 << i : (unsigned long long)i,
+             (unsigned long long)counts[i]);
+    }
+  }
+}
+
+/**
+ * @brief Smallest histogram bucket holding the given fraction of samples.
+ */
+static int percentile(const uint64_t* counts, int buckets, double fraction) {
+  uint64_t total = 0;
+  for (int i = 0; i < buckets; i++) {
+    total += counts[i];
+  }
+  uint64_t seen = 0;
+  for (int i = 0; i < buckets; i++) {
+    seen += counts[i];
+    if (seen && seen >= fraction * total) {
+      return i;
+    }
+  }
+  return buckets - 1;
+}
+
+int main(int argc, char** argv) {
+  uint64_t games = 1000000;
+  workerCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+  int opt;
+  while ((opt = getopt(argc, argv, "g:t:s:m:a2l:eM:")) != -1) {
+    switch (opt) {
+      case 'g':
+        games = strtoull(optarg, NULL, 10);
+        break;
+      case 't':
+        workerCount = atoi(optarg);
+        break;
+      case 's':
+        baseSeed = strtoul(optarg, NULL, 10);
+        break;
+      case 'm':
+        tickLimit = strtoul(optarg, NULL, 10);
+        break;
+      case 'a':
+        autopilot = 1;
+        break;
+      case '2':
+        snakes = MAX_SNAKES;
+        break;
+      case 'l':
+        level = strtoul(optarg, NULL, 10);
+        break;
+      case 'e':
+        failOnTimeout = 1;
+        break;
+      case 'M':
+        minScore = strtod(optarg, NULL);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-g games] [-t threads] [-s seed] "
+                        "[-m ticks] [-a] [-2] [-l level] [-e] "
+                        "[-M score]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (workerCount < 1) {
+    workerCount = 1;
+  }
+
+  workers = calloc(workerCount, sizeof(Worker));
+  if (!workers) {
+    perror("calloc");
+    return 1;
+  }
+  for (int i = 0; i < workerCount; i++) {
+    pthread_mutex_init(&(workers[i].lock), NULL);
+    workers[i].next = games * i / workerCount;
+    workers[i].end = games * (i + 1) / workerCount;
+  }
+
+  uint64_t start = now_ns();
+  for (int i = 0; i < workerCount; i++) {
+    pthread_create(&(workers[i].thread), NULL, work, &workers[i]);
+  }
+  Stats total;
+  memset(&total, 0, sizeof(total));
+  for (int i = 0; i < workerCount; i++) {
+    pthread_join(workers[i].thread, NULL);
+    const uint64_t* from = (const uint64_t*)&(workers[i].stats);
+    uint64_t* to = (uint64_t*)&total;
+    for (size_t j = 0; j < sizeof(Stats) / sizeof(uint64_t); j++) {
+      to[j] += from[j];
+    }
+  }
+  double seconds = (now_ns() - start) / 1e9;
+
+  uint64_t scoreSum = 0;
+  for (int i = 0; i <= GRID_CELLS; i++) {
+    scoreSum += total.score[i] * i;
+  }
+  fprintf(stderr, "%llu games on %d threads in %.2f s: %.0f games/s, "
+                  "%.0f ticks/s\n",
+          (unsigned long long)total.games, workerCount, seconds,
+          total.games / seconds, total.ticks / seconds);
+  double meanScore = total.games ? (double)scoreSum / total.games : 0.0;
+  fprintf(stderr, "mean score %.2f, %llu timeouts\n", meanScore,
+          (unsigned long long)total.timeouts);
+  fprintf(stderr, "tick latency p50 < %llu ns, p99 < %llu ns\n",
+          1ULL << (percentile(total.latency, LATENCY_BUCKETS, 0.5) + 1),
+          1ULL << (percentile(total.latency, LATENCY_BUCKETS, 0.99) + 1));
+  fprintf(stderr, "place_food %llu calls, %.3f draws per call\n",
+          (unsigned long long)total.foods,
+          total.foods ? (double)total.draws / total.foods : 0.0);
+
+  printf("histogram,bucket,count\n");
+  print_histogram("score", total.score, GRID_CELLS + 1, 0);
+  print_histogram("length", total.length, GRID_CELLS + 1, 0);
+  print_histogram("tick_ns", total.latency, LATENCY_BUCKETS, 1);
+  print_histogram("place_food_retries", total.retries, RETRY_BUCKETS, 0);
+  if (meanScore < minScore) {
+    fprintf(stderr, "mean score below %.2f\n", minScore);
+    return 1;
+  }
+  return failOnTimeout && total.timeouts ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+/**
+ * @file sim.h
+ * @brief Header file for the batch simulator's probe hooks.
+ * @note Included by probe.h when SIMULATE is defined.
+ */
+
+#ifndef SNAKE_GAME_SIM_SIM_H
+#define SNAKE_GAME_SIM_SIM_H
+
+#include <stdint.h>
+
+void sim_probe_enter(uint8_t);
+
+void sim_probe_leave(uint8_t);
+
+#endif
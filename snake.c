@@ -0,0 +1,164 @@
+/**
+ * @file snake.c
+ * @brief Snake body storage: a ring of Points or a packed direction chain.
+ * @note With SNAKE_BODY_PACKED the body is the head and tail positions plus
+ * one 2-bit direction per link, four links to a byte. Bodies carry no
+ * occupancy of their own; every snake marks the shared grid in GameState.
+ */
+
+#include <avr/pgmspace.h>
+#include "config.h"
+#include "geometry.h"
+#include "types.h"
+
+#define LINK_BITS 2
+#define LINK_MASK 0x03
+#define LINKS_PER_BYTE (8 / LINK_BITS)
+
+static const uint8_t wrap_x[] PROGMEM = GEOMETRY_WRAP_X;
+static const uint8_t wrap_y[] PROGMEM = GEOMETRY_WRAP_Y;
+
+/**
+ * @brief Moves a point one cell in a direction, wrapping at the borders.
+ * @param p Starting cell.
+ * @param direction One of the DIRECTION_* values.
+ * @return The neighbouring cell.
+ * @note Branch-free: bit 0 of the direction picks the axis and bit 1 the
+ * sign, and the wrap tables take coordinate + 1 so -1 and the grid size
+ * map to the opposite border without a modulo.
+ */
+Point snake_step(Point p, uint8_t direction) {
+  uint8_t vertical = direction & 1;
+  uint8_t step = 1 - (direction & 2);  // 1, or -1 (255) going back
+  p.x = pgm_read_byte(&wrap_x[(uint8_t)(p.x + 1 + (step & (vertical - 1)))]);
+  p.y = pgm_read_byte(&wrap_y[(uint8_t)(p.y + 1 + (step & -vertical))]);
+  return p;
+}
+
+#if SNAKE_BODY_PACKED
+
+/**
+ * @brief Reads the direction stored for a ring slot.
+ * @param snake Pointer to the Snake.
+ * @param index Ring index of the link.
+ * @return Direction from that segment to the next one toward the head.
+ */
+static uint8_t get_link(const Snake* snake, uint16_t index) {
+  uint8_t shift = (index % LINKS_PER_BYTE) * LINK_BITS;
+  return (snake->links[index / LINKS_PER_BYTE] >> shift) & LINK_MASK;
+}
+
+/**
+ * @brief Writes the direction stored for a ring slot.
+ * @param snake Pointer to the Snake.
+ * @param index Ring index of the link.
+ * @param direction Direction from that segment toward the head.
+ */
+static void set_link(Snake* snake, uint16_t index, uint8_t direction) {
+  uint8_t shift = (index % LINKS_PER_BYTE) * LINK_BITS;
+  uint8_t* slot = &(snake->links[index / LINKS_PER_BYTE]);
+  *slot = (*slot & ~(LINK_MASK << shift)) | (direction << shift);
+}
+
+#endif
+
+/**
+ * @brief Resets the body to a single segment.
+ * @param snake Pointer to the Snake.
+ * @param tail Position of the only segment.
+ */
+void snake_reset(Snake* snake, Point tail) {
+  snake->length = 1;
+  snake->head = 0;
+  snake->tail = 0;
+#if SNAKE_BODY_PACKED
+  snake->headPos = tail;
+  snake->tailPos = tail;
+#else
+  snake->body[0] = tail;
+#endif
+}
+
+/**
+ * @brief Pushes a new head segment one step from the current head.
+ * @param snake Pointer to the Snake.
+ * @param direction Direction of travel from the current head.
+ * @note Does not change length; callers track growth.
+ */
+void snake_push(Snake* snake, uint8_t direction) {
+#if SNAKE_BODY_PACKED
+  set_link(snake, snake->head, direction);
+  snake->head = (snake->head + 1) & SNAKE_INDEX_MASK;
+  snake->headPos = snake_step(snake->headPos, direction);
+#else
+  Point newHead = snake_step(snake->body[snake->head], direction);
+  snake->head = (snake->head + 1) & SNAKE_INDEX_MASK;
+  snake->body[snake->head] = newHead;
+#endif
+}
+
+/**
+ * @brief Pops the tail segment off the body.
+ * @param snake Pointer to the Snake.
+ * @note Does not change length; callers track growth.
+ */
+void snake_pop(Snake* snake) {
+#if SNAKE_BODY_PACKED
+  snake->tailPos =
+      snake_step(snake->tailPos, get_link(snake, snake->tail));
+#endif
+  snake->tail = (snake->tail + 1) & SNAKE_INDEX_MASK;
+}
+
+/**
+ * @brief Returns the head position.
+ * @param snake Pointer to the Snake.
+ * @return Position of the head segment.
+ */
+Point snake_head(const Snake* snake) {
+#if SNAKE_BODY_PACKED
+  return snake->headPos;
+#else
+  return snake->body[snake->head];
+#endif
+}
+
+/**
+ * @brief Returns the tail position.
+ * @param snake Pointer to the Snake.
+ * @return Position of the tail segment.
+ */
+Point snake_tail(const Snake* snake) {
+#if SNAKE_BODY_PACKED
+  return snake->tailPos;
+#else
+  return snake->body[snake->tail];
+#endif
+}
+
+/**
+ * @brief Starts an iteration over the body at the tail.
+ * @param snake Pointer to the Snake.
+ * @param it Iterator to initialise; it->remaining counts segments ahead.
+ */
+void snake_first(const Snake* snake, SnakeIter* it) {
+  it->pos = snake_tail(snake);
+  it->index = snake->tail;
+  it->remaining = snake->length - 1;
+}
+
+/**
+ * @brief Advances an iterator one segment toward the head.
+ * @param snake Pointer to the Snake.
+ * @param it Iterator to advance (it->remaining must be non-zero).
+ */
+void snake_next(const Snake* snake, SnakeIter* it) {
+#if SNAKE_BODY_PACKED
+  it->pos = snake_step(it->pos, get_link(snake, it->index));
+  it->index = (it->index + 1) & SNAKE_INDEX_MASK;
+#else
+  it->index = (it->index + 1) & SNAKE_INDEX_MASK;
+  it->pos = snake->body[it->index];
+#endif
+  it->remaining--;
+}
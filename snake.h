@@ -0,0 +1,28 @@
+/**
+ * @file snake.h
+ * @brief Header file for snake body storage and iteration.
+ */
+
+#ifndef SNAKE_GAME_SNAKE_H
+#define SNAKE_GAME_SNAKE_H
+
+#include <stdint.h>
+#include "types.h"
+
+Point snake_step(Point, uint8_t);
+
+void snake_reset(Snake*, Point);
+
+void snake_push(Snake*, uint8_t);
+
+void snake_pop(Snake*);
+
+Point snake_head(const Snake*);
+
+Point snake_tail(const Snake*);
+
+void snake_first(const Snake*, SnakeIter*);
+
+void snake_next(const Snake*, SnakeIter*);
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * @file sprite.h
+ * @brief Header file for the cell sprites used in the Snake game.
+ * @note Each sprite is CELL_SIZE column bytes; bit n is pixel row n within
+ * the cell. Precomputed and stored in flash (see flush_frame in graphic.c).
+ */
+
+#ifndef SNAKE_GAME_SPRITE_H
+#define SNAKE_GAME_SPRITE_H
+
+#include "config.h"
+
+#define SPRITE_WIDTH CELL_SIZE
+
+#if CELL_SIZE == 4
+#define SPRITE_EMPTY {0x00, 0x00, 0x00, 0x00}
+#define SPRITE_BODY {0x07, 0x07, 0x07, 0x00}
+#define SPRITE_HEAD {0x07, 0x05, 0x07, 0x00}
+#define SPRITE_FOOD {0x02, 0x05, 0x02, 0x00}
+#define SPRITE_WALL {0x0A, 0x05, 0x0A, 0x05}
+#else
+#define SPRITE_EMPTY {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
+#define SPRITE_BODY {0x00, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x00}
+#define SPRITE_HEAD {0x00, 0x7E, 0x66, 0x7E, 0x7E, 0x66, 0x7E, 0x00}
+#define SPRITE_FOOD {0x00, 0x38, 0x44, 0x82, 0x82, 0x82, 0x44, 0x38}
+#define SPRITE_WALL {0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55}
+#endif
+
+#define TILE_EMPTY 0
+#define TILE_BODY 1
+#define TILE_HEAD 2
+#define TILE_FOOD 3
+
+#define SPRITES {SPRITE_EMPTY, SPRITE_BODY, SPRITE_HEAD, SPRITE_FOOD}
+
+// Walls are not tiles: they are drawn once per level, see draw_walls()
+
+#endif
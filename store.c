@@ -0,0 +1,176 @@
+/**
+ * @file store.c
+ * @brief High-score table and settings kept in EEPROM across resets.
+ * @note The store region is split into slots of one StoreRecord each. Every
+ * save goes to the slot after the newest one with the next sequence
+ * number, so writes rotate over the whole region instead of wearing out one
+ * spot, and the previous record stays intact until the new one is
+ * complete. At power-on the valid record with the highest sequence wins; a
+ * save torn by a power loss fails its CRC and is ignored. Saves are posted
+ * to the EEPROM ready interrupt and never block the caller.
+ */
+
+#include <stddef.h>
+#include "display.h"
+#include "hal.h"
+#include "replay.h"
+#include "store.h"
+
+#if REPLAY_EEPROM_ADDR + REPLAY_HEADER_BYTES + 2 * REPLAY_CAPACITY > \
+    STORE_EEPROM_ADDR
+#error "The saved recording overlaps the high-score store"
+#endif
+
+static StoreRecord record;   // Current contents, edited in place
+static StoreRecord pending;  // Copy being written by the interrupt
+static uint8_t slot = STORE_SLOTS - 1;  // Slot of the newest record
+static uint8_t dirty = 0;               // Record changed since last post
+
+/**
+ * @brief Computes the CRC-16/CCITT of a record, excluding the CRC itself.
+ * @param r Record to check.
+ * @return CRC value.
+ */
+static uint16_t record_crc(const StoreRecord* r) {
+  const uint8_t* data = (const uint8_t*)r;
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < offsetof(StoreRecord, crc); i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+/**
+ * @brief Loads the newest valid record, or the defaults if there is none.
+ * @note Reads every slot once; call at start-up.
+ */
+void store_init() {
+  uint8_t found = 0;
+  for (uint8_t i = 0; i < STORE_SLOTS; i++) {
+    StoreRecord r;
+    hal_storage_read(STORE_EEPROM_ADDR + i * sizeof(StoreRecord), &r,
+                     sizeof(r));
+    if (r.crc != record_crc(&r))
+      continue;
+    if (!found || (int16_t)(r.sequence - record.sequence) > 0) {
+      record = r;
+      slot = i;
+      found = 1;
+    }
+  }
+  if (!found) {
+    for (uint8_t i = 0; i < HIGH_SCORE_COUNT; i++) {
+      record.scores[i] = 0;
+    }
+    record.sequence = 0;
+    record.moveDelay = MOVE_DELAY;
+    record.contrast = SH1107_CONTRAST_DEFAULT;
+    record.level = 0;
+  }
+}
+
+/**
+ * @brief Saves the record if it changed and the EEPROM is free.
+ * @note Call from the main loop. Changes made while a save is in flight
+ * are picked up by a later call.
+ */
+void store_poll() {
+  if (!dirty || hal_storage_busy())
+    return;
+  record.sequence++;
+  record.crc = record_crc(&record);
+  pending = record;
+  slot = slot + 1 < STORE_SLOTS ? slot + 1 : 0;
+  hal_storage_post(STORE_EEPROM_ADDR + slot * sizeof(StoreRecord), &pending,
+                   sizeof(pending));
+  dirty = 0;
+}
+
+/**
+ * @brief Enters a finished game's score into the high-score table.
+ * @param score Final score.
+ * @return Rank from 0 (best), or HIGH_SCORE_COUNT if it did not place.
+ */
+uint8_t store_submit_score(uint16_t score) {
+  uint8_t rank = HIGH_SCORE_COUNT;
+  while (rank && score > record.scores[rank - 1]) {
+    rank--;
+  }
+  if (rank == HIGH_SCORE_COUNT)
+    return rank;
+  for (uint8_t i = HIGH_SCORE_COUNT - 1; i > rank; i--) {
+    record.scores[i] = record.scores[i - 1];
+  }
+  record.scores[rank] = score;
+  dirty = 1;
+  return rank;
+}
+
+/**
+ * @brief Returns an entry of the high-score table.
+ * @param rank Position from 0 (best) to HIGH_SCORE_COUNT - 1.
+ * @return Score, 0 for an empty entry.
+ */
+uint16_t store_high_score(uint8_t rank) {
+  return record.scores[rank];
+}
+
+/**
+ * @brief Returns the speed setting.
+ * @return Milliseconds per tick.
+ */
+uint16_t store_move_delay() {
+  return record.moveDelay;
+}
+
+/**
+ * @brief Changes the speed setting.
+ * @param delay Milliseconds per tick.
+ */
+void store_set_move_delay(uint16_t delay) {
+  if (delay != record.moveDelay) {
+    record.moveDelay = delay;
+    dirty = 1;
+  }
+}
+
+/**
+ * @brief Returns the contrast setting.
+ * @return SH1107 contrast value.
+ */
+uint8_t store_contrast() {
+  return record.contrast;
+}
+
+/**
+ * @brief Changes the contrast setting.
+ * @param contrast SH1107 contrast value.
+ */
+void store_set_contrast(uint8_t contrast) {
+  if (contrast != record.contrast) {
+    record.contrast = contrast;
+    dirty = 1;
+  }
+}
+
+/**
+ * @brief Returns the level setting.
+ * @return Level number; records from before levels existed read 0.
+ */
+uint8_t store_level() {
+  return record.level;
+}
+
+/**
+ * @brief Changes the level setting.
+ * @param level Level number.
+ */
+void store_set_level(uint8_t level) {
+  if (level != record.level) {
+    record.level = level;
+    dirty = 1;
+  }
+}
@@ -0,0 +1,43 @@
+/**
+ * @file store.h
+ * @brief Header file for the persistent high-score and settings store.
+ */
+
+#ifndef SNAKE_GAME_STORE_H
+#define SNAKE_GAME_STORE_H
+
+#include <stdint.h>
+#include "config.h"
+
+typedef struct {
+  uint16_t sequence;                  // Incremented on every save
+  uint16_t scores[HIGH_SCORE_COUNT];  // Best first
+  uint16_t moveDelay;                 // Milliseconds per tick
+  uint8_t contrast;                   // SH1107 contrast
+  uint8_t level;                      // Level new games start on
+  uint16_t crc;  // CRC-16/CCITT of everything above
+} StoreRecord;
+
+#define STORE_SLOTS ((uint8_t)(STORE_EEPROM_SIZE / sizeof(StoreRecord)))
+
+void store_init();
+
+void store_poll();
+
+uint8_t store_submit_score(uint16_t);
+
+uint16_t store_high_score(uint8_t);
+
+uint16_t store_move_delay();
+
+void store_set_move_delay(uint16_t);
+
+uint8_t store_contrast();
+
+void store_set_contrast(uint8_t);
+
+uint8_t store_level();
+
+void store_set_level(uint8_t);
+
+#endif
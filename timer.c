@@ -0,0 +1,90 @@
+/**
+ * @file timer.c
+ * @brief Monotonic millisecond clock on Timer1 (CTC) and fixed-step scheduler.
+ */
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include "timer.h"
+
+static volatile uint32_t milliseconds = 0;
+
+/**
+ * @brief Starts Timer1 in CTC mode with a 1 ms compare match interrupt.
+ * @note Runs at fosc/1 so TCNT1 counts CPU cycles within the millisecond.
+ */
+void timer_init() {
+  TCCR1A = 0;
+  TCCR1B = (1 << WGM12) | (1 << CS10);  // CTC on OCR1A, no prescaler
+  OCR1A = TIMER_TICKS_PER_MS - 1;
+  TIMSK1 |= (1 << OCIE1A);
+}
+
+/**
+ * @brief Returns milliseconds elapsed since timer_init().
+ * @return Millisecond timestamp (wraps after ~49 days).
+ * @note Safe to call from both main code and interrupt handlers.
+ */
+uint32_t timer_millis() {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t now = milliseconds;
+  SREG = sreg;
+  return now;
+}
+
+/**
+ * @brief Returns CPU cycles elapsed since timer_init().
+ * @return Cycle stamp (wraps after ~268 s at 16 MHz).
+ * @note Combines the millisecond count with TCNT1, which counts cycles.
+ */
+uint32_t timer_cycles() {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t ms = milliseconds;
+  uint16_t ticks = TCNT1;
+  if ((TIFR1 & (1 << OCF1A)) && ticks < TIMER_TICKS_PER_MS / 2) {
+    ms++;  // Compare match pending but not yet serviced
+  }
+  SREG = sreg;
+  return ms * TIMER_TICKS_PER_MS + ticks;
+}
+
+/**
+ * @brief Arms a schedule so its first tick is one period from now.
+ * @param schedule Pointer to the Schedule to start.
+ * @param period Milliseconds between ticks.
+ */
+void schedule_start(Schedule* schedule, uint16_t period) {
+  schedule->period = period;
+  schedule->deadline = timer_millis() + period;
+}
+
+/**
+ * @brief Checks whether the next tick deadline has been reached.
+ * @param schedule Pointer to the Schedule to poll.
+ * @return 1 if a tick is due (and the deadline was advanced), 0 otherwise.
+ * @note Deadlines advance by a fixed period regardless of frame cost. If the
+ * previous tick ran past the following deadline, the overrun is counted and
+ * the schedule re-synchronises instead of firing a burst of late ticks.
+ */
+uint8_t schedule_due(Schedule* schedule) {
+  uint32_t now = timer_millis();
+  if ((int32_t)(now - schedule->deadline) < 0) {
+    return 0;
+  }
+
+  schedule->deadline += schedule->period;
+  if ((int32_t)(now - schedule->deadline) >= 0) {
+    schedule->overruns++;
+    schedule->deadline = now + schedule->period;
+  }
+  return 1;
+}
+
+/**
+ * @brief Timer1 compare match handler, advances the millisecond clock.
+ */
+ISR(TIMER1_COMPA_vect) {
+  milliseconds++;
+}
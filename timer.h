@@ -0,0 +1,29 @@
+/**
+ * @file timer.h
+ * @brief Header file for the Timer1 millisecond clock and tick scheduler.
+ */
+
+#ifndef SNAKE_GAME_TIMER_H
+#define SNAKE_GAME_TIMER_H
+
+#include <stdint.h>
+
+#define TIMER_TICKS_PER_MS (F_CPU / 1000)
+
+typedef struct {
+  uint32_t deadline;  // Millisecond timestamp of the next tick
+  uint16_t period;    // Milliseconds between ticks
+  uint16_t overruns;  // Ticks that started after the following deadline
+} Schedule;
+
+void timer_init();
+
+uint32_t timer_millis();
+
+uint32_t timer_cycles();
+
+void schedule_start(Schedule*, uint16_t);
+
+uint8_t schedule_due(Schedule*);
+
+#endif
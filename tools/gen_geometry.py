@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Generate geometry.h: per-preset board lookup tables for the Snake game.
+
+Each preset in config.h (GEOMETRY_*) gets tables mapping cell rows to
+display pages and pixel rows, cell columns to pixel columns, and
+coordinates one step past either border to their wrapped value. The
+renderer and snake_step() index these instead of multiplying or taking a
+modulo. Rerun after changing a preset: `make geometry`.
+
+Usage: gen_geometry.py > geometry.h
+"""
+
+DISPLAY_WIDTH = 128
+DISPLAY_HEIGHT = 128
+PAGE_HEIGHT = 8
+SCORE_AREA_HEIGHT = 16
+
+# name: (cells across, cells down, cell size in pixels)
+PRESETS = {
+    "16X14": (16, 14, 8),
+    "32X28": (32, 28, 4),
+}
+
+
+def check(name, width, height, cell):
+    """Reject presets the renderer or the autopilot cannot handle."""
+    assert width * cell <= DISPLAY_WIDTH, f"{name}: too wide for the panel"
+    assert SCORE_AREA_HEIGHT + height * cell <= DISPLAY_HEIGHT, \
+        f"{name}: too tall for the panel"
+    assert PAGE_HEIGHT % cell == 0, f"{name}: cells straddle pages"
+    assert width % 8 == 0 and width <= 32, f"{name}: width not 8..32 by 8"
+    assert height % 2 == 0 and height <= 32, f"{name}: height odd or > 32"
+
+
+def table(name, values, indent=2):
+    """Format a brace initialiser macro, wrapped at 80 columns."""
+    single = f"#define {name} {{{', '.join(map(str, values))}}}"
+    if len(single) <= 80:
+        return single
+    lines = []
+    line = " " * indent + "{"
+    for i, value in enumerate(values):
+        item = f"{value}" + (", " if i < len(values) - 1 else "}")
+        if len(line) + len(item.rstrip()) > 76:
+            lines.append(line.rstrip())
+            line = " " * (indent + 1)
+        line += item
+    lines.append(line)
+    width = max(len(l) for l in lines) + 1
+    head = f"#define {name}"
+    out = [head.ljust(width) + "\\"]
+    out += [l.ljust(width) + "\\" for l in lines[:-1]]
+    out.append(lines[-1])
+    return "\n".join(out)
+
+
+def preset(name, width, height, cell):
+    row_y = [SCORE_AREA_HEIGHT + y * cell for y in range(height)]
+    row_page = [y // PAGE_HEIGHT for y in row_y]
+    column_x = [x * cell for x in range(width)]
+    wrap_x = [(x - 1) % width for x in range(width + 2)]
+    wrap_y = [(y - 1) % height for y in range(height + 2)]
+    return "\n".join([
+        f"#if GEOMETRY == GEOMETRY_{name}",
+        f"#if GRID_WIDTH != {width} || GRID_HEIGHT != {height} || "
+        f"CELL_SIZE != {cell} || \\",
+        f"    SCORE_AREA_HEIGHT != {SCORE_AREA_HEIGHT}",
+        '#error "geometry.h does not match config.h, run make geometry"',
+        "#endif",
+        table("GEOMETRY_ROW_PAGE", row_page),
+        table("GEOMETRY_ROW_Y", row_y),
+        table("GEOMETRY_COLUMN_X", column_x),
+        table("GEOMETRY_WRAP_X", wrap_x),
+        table("GEOMETRY_WRAP_Y", wrap_y),
+        "#endif",
+    ])
+
+
+def main():
+    for name, (width, height, cell) in PRESETS.items():
+        check(name, width, height, cell)
+    print("""/**
+ * @file geometry.h
+ * @brief Board geometry checks and lookup tables for every GEOMETRY_*
+ * preset in config.h.
+ * @note Generated by tools/gen_geometry.py (make geometry); do not edit.
+ * Tables are indexed by cell row or column:
+ * - GEOMETRY_ROW_PAGE: display page holding the row
+ * - GEOMETRY_ROW_Y: top pixel row of the row
+ * - GEOMETRY_COLUMN_X: left pixel column of the column
+ * - GEOMETRY_WRAP_X/Y: indexed by coordinate + 1, so -1 and the size
+ *   itself wrap to the opposite border
+ */
+
+#ifndef SNAKE_GAME_GEOMETRY_H
+#define SNAKE_GAME_GEOMETRY_H
+
+#include "config.h"
+#include "display.h"
+
+#if GRID_WIDTH * CELL_SIZE > DISPLAY_WIDTH || \\
+    SCORE_AREA_HEIGHT + GRID_HEIGHT * CELL_SIZE > DISPLAY_HEIGHT
+#error "The play area does not fit below the score bar"
+#endif
+
+#if PAGE_HEIGHT % CELL_SIZE || SCORE_AREA_HEIGHT % PAGE_HEIGHT
+#error "Grid cells must line up with SH1107 pages"
+#endif
+
+#if GRID_WIDTH % 8 || GRID_WIDTH > 32 || GRID_HEIGHT % 2 || GRID_HEIGHT > 32
+#error "Grid width must be 8, 16, 24 or 32 and its height even, at most 32"
+#endif
+
+#define ROWS_PER_PAGE (PAGE_HEIGHT / CELL_SIZE)
+""")
+    for name, (width, height, cell) in PRESETS.items():
+        print(preset(name, width, height, cell))
+        print()
+    print("""#ifndef GEOMETRY_ROW_Y
+#error "No lookup tables for this GEOMETRY, add it to tools/gen_geometry.py"
+#endif
+
+#endif""")
+
+
+if __name__ == "__main__":
+    main()
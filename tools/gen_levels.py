@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Generate levels.h: per-preset wall maps for the Snake game.
+
+Every level is a bit-packed wall map in the layout of the occupancy Grid
+(cell = y * GRID_WIDTH + x, bit cell % 8 of byte cell / 8), so starting a
+level is a copy from flash and the renderer can test any cell in O(1).
+Levels are drawn here as functions of the board size, which keeps them
+alike on every preset; both snakes' start cells must stay free. Rerun
+after changing a level or a preset: `make levels`.
+
+Usage: gen_levels.py > levels.h
+"""
+
+import sys
+
+sys.dont_write_bytecode = True  # Keep tools/ free of __pycache__
+from gen_geometry import PRESETS, table  # noqa: E402
+
+# Start cells from config.h: three cells from the tail toward the heading
+START_LENGTH = 3
+
+
+def starts(width, height):
+    """Cells both snakes occupy after reset_game()."""
+    first = [(1 + i, 4) for i in range(START_LENGTH)]
+    second = [(width - 2 - i, height - 5) for i in range(START_LENGTH)]
+    return first + second
+
+
+def level_open(width, height):
+    """The classic wrap-around board."""
+    return set()
+
+
+def level_box(width, height):
+    """Solid border: the edges no longer wrap."""
+    walls = set()
+    for x in range(width):
+        walls |= {(x, 0), (x, height - 1)}
+    for y in range(height):
+        walls |= {(0, y), (width - 1, y)}
+    return walls
+
+
+def level_gates(width, height):
+    """Border with a two-cell gate in the middle of each side."""
+    gates = {width // 2 - 1, width // 2}
+    sides = {height // 2 - 1, height // 2}
+    return {(x, y) for (x, y) in level_box(width, height)
+            if not (x in gates or y in sides)}
+
+
+def level_bars(width, height):
+    """Gated border plus two bars across the top and bottom quarters."""
+    walls = level_gates(width, height)
+    for x in range(width // 4, width - width // 4):
+        walls |= {(x, 2), (x, height - 3)}
+    return walls
+
+
+LEVELS = [level_open, level_box, level_gates, level_bars]
+
+
+def pack(width, height, walls):
+    """Bit-pack a wall set in Grid order."""
+    data = [0] * (width * height // 8)
+    for x, y in walls:
+        cell = y * width + x
+        data[cell // 8] |= 1 << (cell % 8)
+    return data
+
+
+def preset(name, width, height):
+    lines = [f"#if GEOMETRY == GEOMETRY_{name}"]
+    for number, level in enumerate(LEVELS):
+        walls = level(width, height)
+        blocked = walls & set(starts(width, height))
+        assert not blocked, f"{name} level {number}: walls on {blocked}"
+        lines.append(f"// {number}: {level.__doc__.rstrip('.')}")
+        lines.append(table(f"LEVEL_{number}", pack(width, height, walls)))
+    lines.append("#endif")
+    return "\n".join(lines)
+
+
+def main():
+    print(f"""/**
+ * @file levels.h
+ * @brief Wall maps for every GEOMETRY_* preset in config.h.
+ * @note Generated by tools/gen_levels.py (make levels); do not edit.
+ * LEVEL_n holds GRID_BYTES bytes, one bit per cell in Grid order; a set
+ * bit is a wall. Level 0 is the open wrap-around board.
+ */
+
+#ifndef SNAKE_GAME_LEVELS_H
+#define SNAKE_GAME_LEVELS_H
+
+#include "config.h"
+
+#define LEVEL_COUNT {len(LEVELS)}
+""")
+    for name, (width, height, cell) in PRESETS.items():
+        print(preset(name, width, height))
+        print()
+    print(f"""#ifndef LEVEL_0
+#error "No levels for this GEOMETRY, add it to tools/gen_levels.py"
+#endif
+
+#define LEVELS {{{", ".join(f"LEVEL_{n}" for n in range(len(LEVELS)))}}}
+
+#endif""")
+
+
+if __name__ == "__main__":
+    main()
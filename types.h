@@ -7,19 +7,47 @@
 #define SNAKE_GAME_TYPES_H
 
 #include <stdint.h>
+#include "config.h"
 
 typedef struct {
   uint8_t x;
   uint8_t y;
 } Point;
 
+typedef struct {
+  uint8_t cells[GRID_BYTES];
+  uint16_t used;
+} Grid;
+
+typedef struct {
+  Point pos;
+  uint16_t index;
+  uint16_t remaining;  // Segments left between pos and the head
+} SnakeIter;
+
 typedef struct {
   uint16_t score;
-  uint8_t snakeLength;
-  Point* snake;
+  uint16_t length;
+  uint16_t head;  // Ring index of the head segment
+  uint16_t tail;  // Ring index of the tail segment
+#if SNAKE_BODY_PACKED
+  Point headPos;
+  Point tailPos;
+  uint8_t links[SNAKE_RING_SIZE / 4];  // 2-bit links toward the head
+#else
+  Point body[SNAKE_RING_SIZE];
+#endif
+  volatile uint8_t* direction;  // Direction latched for the next move
+} Snake;
+
+typedef struct {
+  Snake snakes[MAX_SNAKES];
+  uint8_t snakeCount;  // Snakes in play, 1 to MAX_SNAKES
+  uint8_t level;       // Wall map reset_game loads, 0 for the open board
   uint8_t gameOver;
   Point food;
-  volatile uint8_t* direction;
+  Grid occupancy;  // Shared by every snake
+  uint16_t rng;    // Food placement random stream
 } GameState;
 
 #endif
\ No newline at end of file